@@ -6,17 +6,31 @@
 // Modification History:
 // Date         Version        Modified By			Description
 // 03.08.2015   1.0            Said Nuri UYANIK     Initial creation
-// 
+// 19.10.2026   1.1                                 POSIX timerfd backend (ALARM_POSIX)
 //==============================================================================
 
 #include "AlarmXn.hpp"
 #include "znmException.hpp"
 #include <iostream>
+#include <string.h>
+
+#ifdef ALARM_POSIX
+#include <unistd.h>
+#include <time.h>
+#include <sys/timerfd.h>
+#endif
 
 using namespace std;
 
 AlarmXn::AlarmXn(const char* name, RTIME value, RTIME interval){
+#ifdef ALARM_POSIX
+	_timerFd = -1;
+	_expiries = 0;
+#else
 	_alarm = new RT_ALARM;
+#endif
+	_alarmName = NULL;
+	_alarmInfo = NULL;
 	_initShot = value;
 	_interval = interval;
 
@@ -39,90 +53,169 @@ int AlarmXn::create(const char * name){
 
 	mlockall(MCL_CURRENT|MCL_FUTURE);
 
-	if(rt_alarm_create(_alarm, _alarmName) != 0){
+#ifdef ALARM_POSIX
+	_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+
+	if(_timerFd < 0){
 		throw ZnmException("Alarm create failed", "create()", errno);
 	}
+#else
+	int ret = rt_alarm_create(_alarm, _alarmName);
+
+	// Native skin calls return -errno
+	if(ret != 0){
+		throw ZnmException("Alarm create failed", "create()", -ret);
+	}
+#endif
 
 	return 0;
 }
 
 int AlarmXn::destroy(){
+	int ret = 0;
 
-	if(_alarmName)
-		delete [] _alarmName;
-
-	if(_alarm)
+	// Delete the alarm before the memory it lives in, once
+#ifdef ALARM_POSIX
+	if(_timerFd >= 0){
+		ret = close(_timerFd) == 0 ? 0 : errno;
+		_timerFd = -1;
+	}
+#else
+	if(_alarm){
+		ret = -rt_alarm_delete(_alarm);
 		delete _alarm;
+		_alarm = NULL;
+	}
+#endif
+
+	if(_alarmName){
+		delete [] _alarmName;
+		_alarmName = NULL;
+	}
 
-	if(_alarmInfo)
+	if(_alarmInfo){
 		delete _alarmInfo;
+		_alarmInfo = NULL;
+	}
 
-	if(rt_alarm_delete(_alarm) != 0)
-		throw ZnmException("Alarm delete failed", "destroy()", errno);
+	if(ret != 0)
+		throw ZnmException("Alarm delete failed", "destroy()", ret);
 
 	return 0;
 }
 
 RT_ALARM_INFO* AlarmXn::inquire(RT_ALARM_INFO * info){
-	
-	int ret;
-
-	if(info != NULL){
-		ret = rt_alarm_inquire(_alarm, info);
 
-		if(ret != 0)
-			throw ZnmException("alarm inquire failed", "inquire()", errno);
-		
-		return info;
-	}else{
+	if(info == NULL){
 		if(_alarmInfo == NULL){
 			_alarmInfo = new RT_ALARM_INFO;
 		}
-		
-		ret = rt_alarm_inquire(_alarm, _alarmInfo);
 
-		if(ret != 0)
-			throw ZnmException("alarm inquire failed", "inquire()", errno);
-		
-		return _alarmInfo;
+		info = _alarmInfo;
+	}
+
+#ifdef ALARM_POSIX
+	struct itimerspec its;
+	struct timespec now;
+
+	if(timerfd_gettime(_timerFd, &its) != 0)
+		throw ZnmException("alarm inquire failed", "inquire()", errno);
+
+	// timerfd gives the time left, the native skin the date of the shot
+	if(its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0){
+		info->expiration = 0;
+	}else{
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		info->expiration = (RTIME)(now.tv_sec + its.it_value.tv_sec) * 1000000000ULL +
+							now.tv_nsec + its.it_value.tv_nsec;
 	}
+
+	info->expiries = _expiries;
+	strncpy(info->name, _alarmName, ALARM_NAME_LEN - 1);
+	info->name[ALARM_NAME_LEN - 1] = '\0';
+#else
+	int ret = rt_alarm_inquire(_alarm, info);
+
+	if(ret != 0)
+		throw ZnmException("alarm inquire failed", "inquire()", -ret);
+#endif
+
+	return info;
 }
 
 int AlarmXn::start (){
+#ifdef ALARM_POSIX
+	struct itimerspec its;
+	RTIME value = _initShot;
+
+	// A zero value would disarm the timer, the native skin fires at once
+	if(value == 0)
+		value = 1;
+
+	its.it_value.tv_sec = value / 1000000000ULL;
+	its.it_value.tv_nsec = value % 1000000000ULL;
+	its.it_interval.tv_sec = _interval / 1000000000ULL;
+	its.it_interval.tv_nsec = _interval % 1000000000ULL;
+
+	if(timerfd_settime(_timerFd, 0, &its, NULL) != 0){
+		throw ZnmException("alarm start failed", "start()", errno);
+	}
+#else
 	int ret;
 
 	ret = rt_alarm_start(_alarm, _initShot, _interval);
 
 	if (ret != 0){
 		//perror(":");
-		throw ZnmException("alarm start failed", "start()", errno);
+		throw ZnmException("alarm start failed", "start()", -ret);
 	}
-		
+#endif
 
 	return 0;
 }
 
 int AlarmXn::stop (){
+#ifdef ALARM_POSIX
+	struct itimerspec its;
+
+	memset(&its, 0, sizeof(its));
+
+	if(timerfd_settime(_timerFd, 0, &its, NULL) != 0){
+		throw ZnmException("alarm stop failed", "stop()", errno);
+	}
+#else
 	int ret;
 
 	ret = rt_alarm_stop(_alarm);
 
 	if(ret != 0){
-		throw ZnmException("alarm stop failed", "stop()", errno);
+		throw ZnmException("alarm stop failed", "stop()", -ret);
 	}
+#endif
 
 	return 0;
 }
 
 int AlarmXn::wait (){
+#ifdef ALARM_POSIX
+	uint64_t expirations;
+
+	if(read(_timerFd, &expirations, sizeof(expirations)) != sizeof(expirations)){
+		throw ZnmException("alarm wait failed", "wait()", errno);
+	}
+
+	// More than one if wait() was called late
+	_expiries += expirations;
+#else
 	int ret;
 
 	ret = rt_alarm_wait(_alarm);
 
 	if(ret != 0){
 		cout << errno << ret << endl;
-		throw ZnmException("alarm wait failed", "wait()", errno);
+		throw ZnmException("alarm wait failed", "wait()", -ret);
 	}
+#endif
 
 	return 0;
 }
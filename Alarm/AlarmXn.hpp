@@ -6,20 +6,54 @@
 // Modification History:
 // Date         Version        Modified By			Description
 // 03.08.2015   1.0            Said Nuri UYANIK     Initial creation
-// 
+// 19.10.2026   1.1                                 POSIX timerfd backend (ALARM_POSIX)
+// 19.10.2026   1.2                                 Defaults of 3 sec and 1 sec in nanoseconds
 //==============================================================================
 
 #ifndef _ALARM_HPP_INCLUDED
 #define _ALARM_HPP_INCLUDED
 
-#define ALARM_START_OFFSET 300000000000 /* First shot at now + 3 sec */
-#define ALARM_INTERVAL 100000000000 /* Period is 1 sec */
+#define ALARM_START_OFFSET 3000000000ULL /* First shot at now + 3 sec */
+#define ALARM_INTERVAL 1000000000ULL /* Period is 1 sec */
 
 #include <string>
 #include <errno.h>
-#include <native/alarm.h>
 #include <sys/mman.h>
 
+#ifdef ALARM_POSIX
+
+#include <inttypes.h>
+
+#define ALARM_NAME_LEN 32 /* Same as XNOBJECT_NAME_LEN */
+
+/**
+ * Nanoseconds, as RTIME of Xenomai with the aperiodic timer
+ =================================================*/
+typedef uint64_t RTIME;
+
+/**
+ * Same fields as RT_ALARM_INFO of the native skin
+ =================================================*/
+typedef struct rt_alarm_info {
+	RTIME expiration;        // CLOCK_MONOTONIC time of the next shot, 0 if stopped
+	unsigned long expiries;  // Shots so far, including those missed by wait()
+	char name[ALARM_NAME_LEN];
+} RT_ALARM_INFO;
+
+#else
+
+#include <native/alarm.h>
+
+#endif
+
+/**
+ * Periodic alarm, a thread blocks in wait() until the next shot.
+ *
+ * Built with ALARM_POSIX (make ALARM_BACKEND=posix) it uses a Linux
+ * timerfd on CLOCK_MONOTONIC instead of the Xenomai native skin, with
+ * the same interface, so alarm driven code also runs without Xenomai.
+ * Times are in nanoseconds for both backends.
+ =================================================*/
 class AlarmXn
 {
 
@@ -41,7 +75,13 @@ public:
 
 private:
 
+#ifdef ALARM_POSIX
+	int _timerFd;
+
+	unsigned long _expiries;
+#else
 	RT_ALARM* _alarm;
+#endif
 
 	char* _alarmName;
 
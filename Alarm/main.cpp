@@ -0,0 +1,83 @@
+//==============================================================================
+// main.cpp - AlarmXn jitter test, for comparing the alarm backends.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Shadow main under Xenomai, check shots
+//==============================================================================
+#include "AlarmXn.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#ifndef ALARM_POSIX
+#include <native/task.h>
+#endif
+
+#define TEST_PERIOD 1000000LL /* 1 ms */
+#define TEST_SHOTS 1000
+
+static long long nowNs(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+int main(int argc, char const *argv[])
+{
+	int shots = (argc > 1) ? atoi(argv[1]) : TEST_SHOTS;
+	long long first, woken, jitter, minJitter = 0, maxJitter = 0, sum = 0;
+	RT_ALARM_INFO info;
+
+	if(shots < 1){
+		fprintf(stderr, "usage: %s [shots], shots >= 1\n", argv[0]);
+		return 1;
+	}
+
+#ifndef ALARM_POSIX
+	// rt_alarm_wait() is only allowed from a Xenomai task, which needs
+	// its memory locked before it is created
+	RT_TASK task;
+
+	mlockall(MCL_CURRENT|MCL_FUTURE);
+
+	if(rt_task_shadow(&task, "jitter-main", 99, 0) != 0){
+		fprintf(stderr, "rt_task_shadow() failed\n");
+		return 1;
+	}
+#endif
+
+	AlarmXn alarm("jitter", TEST_PERIOD, TEST_PERIOD);
+
+	first = nowNs() + TEST_PERIOD;
+	alarm.start();
+
+	for(int i = 0; i < shots; i++){
+		alarm.wait();
+		woken = nowNs();
+
+		// Shot n is due at first + (n - 1) * period, a late wait()
+		// consumes several shots
+		alarm.inquire(&info);
+		jitter = woken - (first + (long long)(info.expiries - 1) * TEST_PERIOD);
+
+		if(i == 0 || jitter < minJitter)
+			minJitter = jitter;
+		if(i == 0 || jitter > maxJitter)
+			maxJitter = jitter;
+		sum += jitter;
+	}
+
+	alarm.stop();
+
+	printf("%d shots of %lld us: jitter min %lld us, max %lld us, avg %lld us\n",
+			shots, TEST_PERIOD / 1000, minJitter / 1000, maxJitter / 1000,
+			sum / shots / 1000);
+	printf("shots missed: %lu\n", alarm.inquire()->expiries - shots);
+
+	return 0;
+}
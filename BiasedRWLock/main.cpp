@@ -0,0 +1,175 @@
+//==============================================================================
+// main.cpp - Reader scaling of BiasedRWLock against RWLock.
+// Xenomai-version : 2.6.4
+// Compatibility   : Linux, g++
+//
+// Usage: ./run [maxReaders] [milliseconds] [writeInterval]
+//
+// 1..maxReaders threads, pinned to CPUs round robin, take the read lock
+// in a loop for the given time. With writeInterval (us) > 0 one more
+// thread takes the write lock that often. Prints read lock/unlock pairs
+// per microsecond over all readers, and the write locks taken.
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+//==============================================================================
+#include "RWLock.hpp"
+#include "BiasedRWLock.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define TEST_READERS 8
+#define TEST_MSEC 500
+#define TEST_MAX_THREADS 64
+
+template <typename LOCK>
+struct TestArgs
+{
+	LOCK* lock;
+	pthread_barrier_t* start;
+	volatile int* stop;
+	int cpu;
+	int interval;
+	long count;
+	volatile long* data;
+};
+
+static long long nowNs(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pinTo(int cpu){
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+template <typename LOCK>
+static void* reader(void* arg){
+	TestArgs<LOCK>* args = (TestArgs<LOCK>*) arg;
+	long sum = 0;
+
+	pinTo(args->cpu);
+	pthread_barrier_wait(args->start);
+
+	while(!*args->stop){
+		args->lock->readLock();
+		sum += *args->data;
+		args->lock->unlock();
+		args->count++;
+	}
+
+	// Keep the read from being optimized away
+	if(sum == -1)
+		printf("%ld\n", sum);
+
+	return NULL;
+}
+
+template <typename LOCK>
+static void* writer(void* arg){
+	TestArgs<LOCK>* args = (TestArgs<LOCK>*) arg;
+
+	pinTo(args->cpu);
+	pthread_barrier_wait(args->start);
+
+	while(!*args->stop){
+		usleep(args->interval);
+		args->lock->writeLock();
+		*args->data = *args->data + 1;
+		args->lock->unlock();
+		args->count++;
+	}
+
+	return NULL;
+}
+
+// Returns read pairs per us; *writes gets the number of write locks
+template <typename LOCK>
+static double measure(LOCK* lock, int readers, int msec, int interval, long* writes){
+	pthread_t ids[TEST_MAX_THREADS + 1];
+	TestArgs<LOCK> args[TEST_MAX_THREADS + 1];
+	pthread_barrier_t start;
+	volatile int stop = 0;
+	volatile long data = 0;
+	int threads = readers + (interval > 0 ? 1 : 0);
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	long long begin;
+	long long end;
+	long reads = 0;
+
+	pthread_barrier_init(&start, NULL, threads + 1);
+
+	for(int i = 0; i < threads; i++){
+		args[i].lock = lock;
+		args[i].start = &start;
+		args[i].stop = &stop;
+		args[i].cpu = i % cpus;
+		args[i].interval = interval;
+		args[i].count = 0;
+		args[i].data = &data;
+		pthread_create(&ids[i], NULL, i < readers ? reader<LOCK> : writer<LOCK>, &args[i]);
+	}
+
+	pthread_barrier_wait(&start);
+	begin = nowNs();
+	usleep(msec * 1000);
+	stop = 1;
+
+	for(int i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+
+	end = nowNs();
+	pthread_barrier_destroy(&start);
+
+	for(int i = 0; i < readers; i++)
+		reads += args[i].count;
+
+	*writes = (interval > 0) ? args[readers].count : 0;
+
+	return (double)reads * 1000.0 / (double)(end - begin);
+}
+
+int main(int argc, char const *argv[])
+{
+	int maxReaders = (argc > 1) ? atoi(argv[1]) : TEST_READERS;
+	int msec = (argc > 2) ? atoi(argv[2]) : TEST_MSEC;
+	int interval = (argc > 3) ? atoi(argv[3]) : 0;
+	RWLock rwLock;
+	BiasedRWLock biasedLock;
+	long rwWrites;
+	long biasedWrites;
+	double rwReads;
+	double biasedReads;
+
+	if(maxReaders < 1 || maxReaders > TEST_MAX_THREADS || msec < 1 || interval < 0){
+		fprintf(stderr, "usage: %s [maxReaders 1..%d] [milliseconds] [writeInterval us]\n",
+				argv[0], TEST_MAX_THREADS);
+		return 1;
+	}
+
+	printf("%ld cpus, %d ms per run, ", sysconf(_SC_NPROCESSORS_ONLN), msec);
+	if(interval > 0)
+		printf("one writer every %d us\n", interval);
+	else
+		printf("no writer\n");
+	printf("readers   RWLock reads/us (writes)   BiasedRWLock reads/us (writes)\n");
+
+	for(int n = 1; n <= maxReaders; n++){
+		rwReads = measure(&rwLock, n, msec, interval, &rwWrites);
+		biasedReads = measure(&biasedLock, n, msec, interval, &biasedWrites);
+		printf("%7d   %15.2f (%6ld)   %21.2f (%6ld)\n", n,
+				rwReads, rwWrites, biasedReads, biasedWrites);
+		fflush(stdout);
+	}
+
+	return 0;
+}
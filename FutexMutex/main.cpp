@@ -0,0 +1,132 @@
+//==============================================================================
+// main.cpp - FutexMutexXp against MutexXp with 1..N contending threads.
+// Xenomai-version : 2.6.4
+// Compatibility   : Linux, g++
+//
+// Usage: ./run [maxThreads] [lockCount] [spinCount]
+//
+// Every thread is pinned to a CPU (round robin) and takes the lock
+// lockCount times around a short critical section. Prints the average
+// time of one lock/unlock pair, seen from the whole process.
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+//==============================================================================
+#include "MutexXp.hpp"
+#include "FutexMutexXp.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define TEST_THREADS 8
+#define TEST_LOCKS 1000000
+#define TEST_MAX_THREADS 64
+
+template <typename LOCK>
+struct TestArgs
+{
+	LOCK* lock;
+	pthread_barrier_t* start;
+	int cpu;
+	int locks;
+	volatile long* counter;
+};
+
+static long long nowNs(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pinTo(int cpu){
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+template <typename LOCK>
+static void* contend(void* arg){
+	TestArgs<LOCK>* args = (TestArgs<LOCK>*) arg;
+
+	pinTo(args->cpu);
+	pthread_barrier_wait(args->start);
+
+	for(int i = 0; i < args->locks; i++){
+		args->lock->lock();
+		// Short critical section, a read-modify-write of shared data
+		*args->counter = *args->counter + 1;
+		args->lock->unlock();
+	}
+
+	return NULL;
+}
+
+// Returns ns per lock/unlock pair, or -1 if the counter came out wrong
+template <typename LOCK>
+static double measure(LOCK* lock, int threads, int locks){
+	pthread_t ids[TEST_MAX_THREADS];
+	TestArgs<LOCK> args[TEST_MAX_THREADS];
+	pthread_barrier_t start;
+	volatile long counter = 0;
+	long long begin;
+	long long end;
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+	pthread_barrier_init(&start, NULL, threads + 1);
+
+	for(int i = 0; i < threads; i++){
+		args[i].lock = lock;
+		args[i].start = &start;
+		args[i].cpu = i % cpus;
+		args[i].locks = locks;
+		args[i].counter = &counter;
+		pthread_create(&ids[i], NULL, contend<LOCK>, &args[i]);
+	}
+
+	pthread_barrier_wait(&start);
+	begin = nowNs();
+
+	for(int i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+
+	end = nowNs();
+	pthread_barrier_destroy(&start);
+
+	if(counter != (long)threads * locks)
+		return -1;
+
+	return (double)(end - begin) / ((double)threads * locks);
+}
+
+int main(int argc, char const *argv[])
+{
+	int maxThreads = (argc > 1) ? atoi(argv[1]) : TEST_THREADS;
+	int locks = (argc > 2) ? atoi(argv[2]) : TEST_LOCKS;
+	int spinCount = (argc > 3) ? atoi(argv[3]) : FUTEX_MUTEX_SPIN;
+	MutexXp mutex;
+	FutexMutexXp futexMutex(spinCount);
+
+	if(maxThreads < 1 || maxThreads > TEST_MAX_THREADS || locks < 1){
+		fprintf(stderr, "usage: %s [maxThreads 1..%d] [lockCount] [spinCount]\n",
+				argv[0], TEST_MAX_THREADS);
+		return 1;
+	}
+
+	printf("%ld cpus, %d locks per thread, spin count %d\n",
+			sysconf(_SC_NPROCESSORS_ONLN), locks, spinCount);
+	printf("threads   MutexXp ns/op   FutexMutexXp ns/op\n");
+
+	for(int n = 1; n <= maxThreads; n++){
+		printf("%7d   %13.1f   %18.1f\n", n,
+				measure(&mutex, n, locks),
+				measure(&futexMutex, n, locks));
+		fflush(stdout);
+	}
+
+	return 0;
+}
@@ -0,0 +1,244 @@
+//==============================================================================
+// main.cpp - Fairness and cache traffic of the ticket and MCS spin locks
+//            against a test-and-set lock.
+// Xenomai-version : 2.6.4
+// Compatibility   : Linux, g++
+//
+// Usage: ./run [threads] [milliseconds]
+//
+// Every thread is pinned to its own CPU (round robin if there are fewer
+// CPUs) and takes the lock in a loop for the given time. Per lock the
+// program prints:
+//  - acquisitions of every thread, and min/max of them: a FIFO lock keeps
+//    them close, a test-and-set lock lets the thread that just released
+//    the lock take it again,
+//  - the longest streak of acquisitions by one thread in a row; with all
+//    threads contending on their own CPUs a FIFO lock keeps it at 1 to 2,
+//  - cache misses per acquisition from the performance counters, if the
+//    kernel allows them (perf_event_paranoid), as a measure of the cache
+//    line transfers spinning causes.
+// Run it on isolated CPUs: a spin lock waiter sharing a CPU with the holder
+// spins for its whole time slice.
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+//==============================================================================
+#include "SpinLockXp.hpp"
+#include "FutexXp.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#define TEST_MSEC 500
+#define TEST_MAX_THREADS 64
+
+/**
+ * Test-and-set lock to compare against: every waiter writes the lock
+ * word on every try, so the line bounces between all spinning CPUs.
+ =================================================*/
+class TasSpinLock
+{
+	public:
+		TasSpinLock(){ _locked = 0; }
+
+		void lock(){
+			while(__atomic_exchange_n(&_locked, 1, __ATOMIC_ACQUIRE) != 0)
+				cpuRelax();
+		}
+
+		void unlock(){
+			__atomic_store_n(&_locked, 0, __ATOMIC_RELEASE);
+		}
+
+	private:
+		uint32_t _locked;
+};
+
+/**
+ * Owner history, only touched with the lock held.
+ =================================================*/
+struct TestShared
+{
+	int lastOwner;
+	long streak;
+	long maxStreak;
+	volatile int stop;
+};
+
+template <typename LOCK>
+struct TestArgs
+{
+	LOCK* lock;
+	TestShared* shared;
+	pthread_barrier_t* start;
+	int id;
+	int cpu;
+	long count;
+	long long misses;	// -1 if counters are not available
+} __attribute__((aligned(64)));
+
+static long long nowNs(){
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void pinTo(int cpu){
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// Counts cache misses of the calling thread, -1 if not permitted
+static int openMissCounter(){
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+template <typename LOCK>
+static void* contend(void* arg){
+	TestArgs<LOCK>* args = (TestArgs<LOCK>*) arg;
+	TestShared* shared = args->shared;
+	long long misses;
+	int counter;
+
+	pinTo(args->cpu);
+	counter = openMissCounter();
+	pthread_barrier_wait(args->start);
+
+	if(counter >= 0)
+		ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+
+	while(!shared->stop){
+		args->lock->lock();
+
+		if(shared->lastOwner == args->id){
+			if(++shared->streak > shared->maxStreak)
+				shared->maxStreak = shared->streak;
+		}else{
+			shared->lastOwner = args->id;
+			shared->streak = 1;
+		}
+
+		args->lock->unlock();
+		args->count++;
+	}
+
+	args->misses = -1;
+
+	if(counter >= 0){
+		ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+		if(read(counter, &misses, sizeof(misses)) == sizeof(misses))
+			args->misses = misses;
+		close(counter);
+	}
+
+	return NULL;
+}
+
+template <typename LOCK>
+static void measure(const char* name, int threads, int msec){
+	pthread_t ids[TEST_MAX_THREADS];
+	TestArgs<LOCK> args[TEST_MAX_THREADS];
+	pthread_barrier_t start;
+	TestShared shared;
+	LOCK lock;
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	long long begin;
+	long long end;
+	long long misses = 0;
+	long total = 0;
+	long minCount;
+	long maxCount;
+
+	shared.lastOwner = -1;
+	shared.streak = 0;
+	shared.maxStreak = 0;
+	shared.stop = 0;
+	pthread_barrier_init(&start, NULL, threads + 1);
+
+	for(int i = 0; i < threads; i++){
+		args[i].lock = &lock;
+		args[i].shared = &shared;
+		args[i].start = &start;
+		args[i].id = i;
+		args[i].cpu = i % cpus;
+		args[i].count = 0;
+		pthread_create(&ids[i], NULL, contend<LOCK>, &args[i]);
+	}
+
+	pthread_barrier_wait(&start);
+	begin = nowNs();
+	usleep(msec * 1000);
+	shared.stop = 1;
+
+	for(int i = 0; i < threads; i++)
+		pthread_join(ids[i], NULL);
+
+	end = nowNs();
+	pthread_barrier_destroy(&start);
+
+	minCount = maxCount = args[0].count;
+	printf("%-8s per thread:", name);
+
+	for(int i = 0; i < threads; i++){
+		printf(" %ld", args[i].count);
+		total += args[i].count;
+		if(args[i].count < minCount)
+			minCount = args[i].count;
+		if(args[i].count > maxCount)
+			maxCount = args[i].count;
+		if(misses >= 0)
+			misses = (args[i].misses >= 0) ? misses + args[i].misses : -1;
+	}
+
+	printf("\n%-8s %.2f locks/us, min/max %.3f, longest streak %ld, ",
+			name, (double)total * 1000.0 / (double)(end - begin),
+			maxCount ? (double)minCount / (double)maxCount : 0.0,
+			shared.maxStreak);
+
+	if(misses >= 0 && total > 0)
+		printf("cache misses/lock %.2f\n", (double)misses / (double)total);
+	else
+		printf("cache misses n/a\n");
+}
+
+int main(int argc, char const *argv[])
+{
+	int cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	int threads = (argc > 1) ? atoi(argv[1]) : (cpus > 1 ? cpus : 2);
+	int msec = (argc > 2) ? atoi(argv[2]) : TEST_MSEC;
+
+	if(threads < 1 || threads > TEST_MAX_THREADS || msec < 1){
+		fprintf(stderr, "usage: %s [threads 1..%d] [milliseconds]\n",
+				argv[0], TEST_MAX_THREADS);
+		return 1;
+	}
+
+	printf("%d threads on %d cpus, %d ms per lock\n", threads, cpus, msec);
+	if(threads > cpus)
+		printf("warning: more threads than cpus, waiters spin out their time slice\n");
+
+	measure<TasSpinLock>("tas", threads, msec);
+	measure<TicketSpinLockXp>("ticket", threads, msec);
+	measure<McsSpinLockXp>("mcs", threads, msec);
+
+	return 0;
+}
@@ -0,0 +1,344 @@
+//==============================================================================
+// BiasedRWLock.hpp - Reader biased, scalable reader/writer lock.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _BIASEDRWLOCK_HPP_INCLUDED
+#define _BIASEDRWLOCK_HPP_INCLUDED
+
+#include <pthread.h>
+#include <time.h>
+#include <inttypes.h>
+#include "ErrnoException.hpp"
+#include "FutexXp.hpp"
+
+#define BRAVO_SLOTS 64        // Visible reader slots per lock (one cache line each)
+#define BRAVO_INHIBIT_FACTOR 9 // Bias stays off for this many times the revocation cost
+#define BRAVO_CACHE_LINE 64
+
+//==============================================================================
+// class BiasedRWLock
+//------------------------------------------------------------------------------
+// \brief
+// A reader/writer lock for read-mostly data, with the same interface as
+// RWLock.
+//
+// <ul>
+// <li>pthread_rwlock keeps its reader count in one word, so every
+//     readLock()/unlock() on any core writes the same cache line.
+//     BiasedRWLock (after the BRAVO design by Dice and Kogan) lets a
+//     reader announce itself in a slot of its own instead, so while the
+//     lock is read biased, readers on different cores do not share any
+//     written cache line.
+// <li>A writer takes the underlying pthread lock, turns the bias off and
+//     waits until the slots are empty. It therefore waits only for
+//     readers already inside their critical section, never for new ones.
+//     The bias is not turned on again for BRAVO_INHIBIT_FACTOR times
+//     the time the revocation took, which bounds the cost writers pay.
+// <li>Readers that find their slot taken or the bias off use the
+//     underlying lock, which prefers writers.
+// <li>Process private only: slots are assigned per thread of this
+//     process.
+// <li>Not recursive. A thread must not take a read lock it already holds.
+// <li>This class will throw an exception of type ErrnoException in case of
+//     errors.
+// </ul>
+//==============================================================================
+
+class BiasedRWLock
+{
+ public:
+  inline BiasedRWLock();
+   // Constructor initializes the lock.
+
+  inline ~BiasedRWLock();
+   // Destroys the lock.
+
+  inline void readLock();
+   // Acquire the lock for read access.
+   // If the lock is not available, block until it is.
+
+  inline int tryReadLock();
+   // Try to acquire the lock for read access.
+   //  return  0 on successful acquisition of lock, else -1
+
+  inline void writeLock();
+   // Acquire the lock for exclusive write access.
+   // If the lock is not available, block until it is.
+
+  inline int tryWriteLock();
+   // Try to acquire the lock for exclusive write access. Does not
+   // wait for other writers, but does wait for readers already
+   // inside their critical section if the lock was read biased.
+   //  return  0 on successful acquisition of lock, else -1
+
+  inline void unlock();
+   // Unlock the lock held for read or write access.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  struct Slot
+  {
+   BiasedRWLock *owner;
+   void *thread;
+    // Tag of the owning thread, slots are shared beyond BRAVO_SLOTS threads
+   char pad[BRAVO_CACHE_LINE - 2 * sizeof(void *)];
+  } __attribute__((aligned(BRAVO_CACHE_LINE)));
+
+  static inline int threadSlot();
+   // Slot index of the calling thread
+
+  static inline void *threadTag();
+   // Unique per live thread
+
+  static inline uint64_t now();
+
+  inline bool fastReadLock();
+
+  inline void revokeBias();
+   // Called with the write lock held
+
+  inline void errorCheck(int code);
+
+  Slot d_slots[BRAVO_SLOTS];
+   // Visible readers, each on its own cache line
+
+  int d_readBias;
+   // Readers may use the slots
+
+  uint64_t d_inhibitUntil;
+   // Bias stays off until this time (ns)
+
+  pthread_rwlock_t d_rwl;
+   // Underlying lock for writers and slow readers
+};
+
+
+//==============================================================================
+// BiasedRWLock::BiasedRWLock
+//==============================================================================
+BiasedRWLock::BiasedRWLock()
+{
+ pthread_rwlockattr_t attr;
+
+ for(int i = 0; i < BRAVO_SLOTS; i++)
+ {
+  d_slots[i].owner = NULL;
+  d_slots[i].thread = NULL;
+ }
+ d_readBias = 1;
+ d_inhibitUntil = 0;
+
+ errorCheck( pthread_rwlockattr_init(&attr) );
+ errorCheck( pthread_rwlockattr_setpshared(&attr, PTHREAD_PROCESS_PRIVATE) );
+#ifdef __GLIBC__
+ // Slow readers queue behind a waiting writer
+ errorCheck( pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP) );
+#endif
+ errorCheck( pthread_rwlock_init(&d_rwl, &attr) );
+ pthread_rwlockattr_destroy(&attr);
+}
+
+
+//==============================================================================
+// BiasedRWLock::~BiasedRWLock
+//==============================================================================
+BiasedRWLock::~BiasedRWLock()
+{
+ pthread_rwlock_destroy(&d_rwl);
+}
+
+
+//==============================================================================
+// BiasedRWLock::readLock
+//==============================================================================
+void BiasedRWLock::readLock()
+{
+ if(fastReadLock())
+  return;
+
+ errorCheck( pthread_rwlock_rdlock(&d_rwl) );
+
+ // Re-enable the bias once the inhibit window is over
+ if(!__atomic_load_n(&d_readBias, __ATOMIC_RELAXED) &&
+    now() >= __atomic_load_n(&d_inhibitUntil, __ATOMIC_RELAXED))
+  __atomic_store_n(&d_readBias, 1, __ATOMIC_RELEASE);
+}
+
+
+//==============================================================================
+// BiasedRWLock::tryReadLock
+//==============================================================================
+int BiasedRWLock::tryReadLock()
+{
+ int retVal;
+
+ if(fastReadLock())
+  return 0;
+
+ retVal = pthread_rwlock_tryrdlock(&d_rwl);
+
+ if( retVal == 0 )
+  return 0;
+
+ if( retVal == EAGAIN || retVal == EBUSY )
+  return -1;
+
+ errorCheck(retVal);
+ return -1;
+}
+
+
+//==============================================================================
+// BiasedRWLock::writeLock
+//==============================================================================
+void BiasedRWLock::writeLock()
+{
+ errorCheck( pthread_rwlock_wrlock(&d_rwl) );
+ revokeBias();
+}
+
+
+//==============================================================================
+// BiasedRWLock::tryWriteLock
+//==============================================================================
+int BiasedRWLock::tryWriteLock()
+{
+ int retVal;
+
+ retVal = pthread_rwlock_trywrlock(&d_rwl);
+
+ if( retVal == 0 )
+ {
+  revokeBias();
+  return 0;
+ }
+
+ if( retVal == EAGAIN || retVal == EBUSY )
+  return -1;
+
+ errorCheck(retVal);
+ return -1;
+}
+
+
+//==============================================================================
+// BiasedRWLock::unlock
+//==============================================================================
+void BiasedRWLock::unlock()
+{
+ Slot *slot = &d_slots[threadSlot()];
+
+ // Only a fast path reader of this lock leaves itself in the slot
+ if(__atomic_load_n(&slot->owner, __ATOMIC_RELAXED) == this &&
+    __atomic_load_n(&slot->thread, __ATOMIC_RELAXED) == threadTag())
+ {
+  __atomic_store_n(&slot->thread, (void *)NULL, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->owner, (BiasedRWLock *)NULL, __ATOMIC_RELEASE);
+  return;
+ }
+
+ errorCheck( pthread_rwlock_unlock(&d_rwl) );
+}
+
+
+//==============================================================================
+// BiasedRWLock::threadSlot
+//==============================================================================
+int BiasedRWLock::threadSlot()
+{
+ static unsigned int nextSlot = 0;
+ static __thread int slot = -1;
+
+ if(slot < 0)
+  slot = __atomic_fetch_add(&nextSlot, 1, __ATOMIC_RELAXED) % BRAVO_SLOTS;
+ return slot;
+}
+
+
+//==============================================================================
+// BiasedRWLock::threadTag
+//==============================================================================
+void *BiasedRWLock::threadTag()
+{
+ static __thread char tag;
+ return &tag;
+}
+
+
+//==============================================================================
+// BiasedRWLock::now
+//==============================================================================
+uint64_t BiasedRWLock::now()
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+//==============================================================================
+// BiasedRWLock::fastReadLock
+//==============================================================================
+bool BiasedRWLock::fastReadLock()
+{
+ Slot *slot;
+ BiasedRWLock *expected = NULL;
+
+ if(!__atomic_load_n(&d_readBias, __ATOMIC_ACQUIRE))
+  return false;
+
+ slot = &d_slots[threadSlot()];
+ if(!__atomic_compare_exchange_n(&slot->owner, &expected, this, false,
+                                 __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+  return false;
+ __atomic_store_n(&slot->thread, threadTag(), __ATOMIC_RELAXED);
+
+ // Recheck: a writer clears the bias before scanning the slots
+ if(__atomic_load_n(&d_readBias, __ATOMIC_SEQ_CST))
+  return true;
+
+ __atomic_store_n(&slot->thread, (void *)NULL, __ATOMIC_RELAXED);
+ __atomic_store_n(&slot->owner, (BiasedRWLock *)NULL, __ATOMIC_RELEASE);
+ return false;
+}
+
+
+//==============================================================================
+// BiasedRWLock::revokeBias
+//==============================================================================
+void BiasedRWLock::revokeBias()
+{
+ uint64_t start;
+
+ if(!__atomic_load_n(&d_readBias, __ATOMIC_RELAXED))
+  return;
+
+ __atomic_store_n(&d_readBias, 0, __ATOMIC_SEQ_CST);
+
+ // Store/load handshake with fastReadLock(): both sides must be seq_cst,
+ // or a reader's slot claim and our bias store could pass each other
+ start = now();
+ for(int i = 0; i < BRAVO_SLOTS; i++)
+  while(__atomic_load_n(&d_slots[i].owner, __ATOMIC_SEQ_CST) == this)
+   cpuRelax();
+
+ __atomic_store_n(&d_inhibitUntil, now() + (now() - start) * BRAVO_INHIBIT_FACTOR,
+                  __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// BiasedRWLock::errorCheck
+//==============================================================================
+void BiasedRWLock::errorCheck(int code)
+{
+ if(code == 0) return;
+ throw(ErrnoException(code, "[BiasedRWLock]"));
+}
+
+#endif // _BIASEDRWLOCK_HPP_INCLUDED
@@ -0,0 +1,553 @@
+//==============================================================================
+// CoSchedulerXp.cpp - Cooperative tasks multiplexed on one thread.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "CoSchedulerXp.hpp"
+#include "znmException.hpp"
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+
+//==============================================================================
+// CoTaskXp::CoTaskXp
+//==============================================================================
+CoTaskXp::CoTaskXp()
+{
+ d_coLine = 0;
+ d_coResult = 0;
+ d_scheduler = NULL;
+ d_next = NULL;
+ d_heapIndex = -1;
+ d_deadline = -1;
+ d_fd = -1;
+ d_waitFd = -1;
+ d_done = true;
+}
+
+
+//==============================================================================
+// CoTaskXp::~CoTaskXp
+//==============================================================================
+CoTaskXp::~CoTaskXp()
+{
+}
+
+
+//==============================================================================
+// CoTaskXp::isDone
+//==============================================================================
+bool CoTaskXp::isDone() const
+{
+ return d_done;
+}
+
+
+//==============================================================================
+// CoTaskXp::getWaitResult
+//==============================================================================
+int CoTaskXp::getWaitResult() const
+{
+ return d_coResult;
+}
+
+
+//==============================================================================
+// CoTaskXp::waitFd
+//==============================================================================
+int CoTaskXp::waitFd(int fd, uint32_t events, int64_t deadline)
+{
+ d_coResult = d_scheduler->wait(this, fd, events, deadline);
+ return d_coResult;
+}
+
+
+//==============================================================================
+// CoEventXp::CoEventXp
+//==============================================================================
+CoEventXp::CoEventXp()
+{
+ d_set = false;
+ d_waiters = NULL;
+}
+
+
+//==============================================================================
+// CoEventXp::set
+//==============================================================================
+void CoEventXp::set()
+{
+ CoTaskXp *task;
+
+ d_set = true;
+ while(d_waiters != NULL)
+ {
+  task = d_waiters;
+  d_waiters = task->d_next;
+  task->d_scheduler->makeReady(task, 0);
+ }
+}
+
+
+//==============================================================================
+// CoEventXp::reset
+//==============================================================================
+void CoEventXp::reset()
+{
+ d_set = false;
+}
+
+
+//==============================================================================
+// CoEventXp::isSet
+//==============================================================================
+bool CoEventXp::isSet() const
+{
+ return d_set;
+}
+
+
+//==============================================================================
+// CoEventXp::wait
+//==============================================================================
+void CoEventXp::wait(CoTaskXp *task)
+{
+ task->d_next = d_waiters;
+ d_waiters = task;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::CoSchedulerXp
+//==============================================================================
+CoSchedulerXp::CoSchedulerXp(int maxTasks /*= CO_MAX_TASKS*/,
+                             int policy /*= SCHED_OTHER*/,
+                             int sched_priority /*= 0*/,
+                             const cpu_set_t *cpuMask /*= NULL*/,
+                             const char *name /*= "co-scheduler"*/)
+ : ThreadXp(PTHREAD_CREATE_JOINABLE, PTHREAD_STACK_MIN, PTHREAD_EXPLICIT_SCHED,
+            policy, sched_priority, name, 1, cpuMask)
+{
+ struct epoll_event ev;
+ int errNumber;
+
+ if(maxTasks <= 0)
+  throw ZnmException("CoSchedulerXp", "maxTasks", EINVAL);
+
+ d_maxTasks = maxTasks;
+ d_numTasks = 0;
+ d_readyHead = NULL;
+ d_readyTail = NULL;
+ d_heapSize = 0;
+ d_armed = -1;
+ d_stop = 0;
+
+ d_epollFd = epoll_create1(EPOLL_CLOEXEC);
+ d_timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+ d_stopFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+ errNumber = errno;
+ if(d_epollFd < 0 || d_timerFd < 0 || d_stopFd < 0)
+ {
+  close(d_epollFd);
+  close(d_timerFd);
+  close(d_stopFd);
+  throw ZnmException("CoSchedulerXp", "descriptor", errNumber);
+ }
+
+ // The two own descriptors are told apart from tasks by address
+ ev.events = EPOLLIN;
+ ev.data.ptr = &d_timerFd;
+ epoll_ctl(d_epollFd, EPOLL_CTL_ADD, d_timerFd, &ev);
+ ev.data.ptr = &d_stopFd;
+ epoll_ctl(d_epollFd, EPOLL_CTL_ADD, d_stopFd, &ev);
+
+ d_heap = new CoTaskXp *[maxTasks];
+}
+
+
+//==============================================================================
+// CoSchedulerXp::~CoSchedulerXp
+//==============================================================================
+CoSchedulerXp::~CoSchedulerXp()
+{
+ close(d_epollFd);
+ close(d_timerFd);
+ close(d_stopFd);
+ delete [] d_heap;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::spawn
+//==============================================================================
+int CoSchedulerXp::spawn(CoTaskXp *task)
+{
+ if(!task->d_done)
+  return EBUSY;
+ if(d_numTasks >= d_maxTasks)
+  return ENOSPC;
+
+ task->d_scheduler = this;
+ task->d_coLine = 0;
+ task->d_coResult = 0;
+ task->d_heapIndex = -1;
+ task->d_fd = -1;
+ task->d_waitFd = -1;
+ task->d_done = false;
+ d_numTasks++;
+ makeReady(task, 0);
+ return 0;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::stop
+//==============================================================================
+void CoSchedulerXp::stop()
+{
+ uint64_t one = 1;
+
+ __atomic_store_n(&d_stop, 1, __ATOMIC_RELEASE);
+ if(write(d_stopFd, &one, sizeof(one)) < 0)
+ {
+  // Already signalled
+ }
+}
+
+
+//==============================================================================
+// CoSchedulerXp::getTaskCount
+//==============================================================================
+int CoSchedulerXp::getTaskCount() const
+{
+ return d_numTasks;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::enterThread
+//==============================================================================
+void CoSchedulerXp::enterThread(void * /*arg*/)
+{
+}
+
+
+//==============================================================================
+// CoSchedulerXp::executeInThread
+//==============================================================================
+int CoSchedulerXp::executeInThread(void * /*arg*/)
+{
+ CoTaskXp *task;
+ uint64_t count;
+ int n;
+
+ while(!__atomic_load_n(&d_stop, __ATOMIC_ACQUIRE) && d_numTasks > 0)
+ {
+  runReady();
+  if(d_numTasks == 0)
+   break;
+  armTimer();
+
+  // Do not block while some task is ready to run
+  n = epoll_wait(d_epollFd, d_events, CO_EPOLL_EVENTS,
+                 d_readyHead != NULL ? 0 : -1);
+  if(n < 0)
+  {
+   if(errno == EINTR)
+    continue;
+   return errno;
+  }
+
+  for(int i = 0; i < n; i++)
+  {
+   if(d_events[i].data.ptr == &d_timerFd)
+   {
+    if(read(d_timerFd, &count, sizeof(count)) < 0)
+    {
+     // Nothing expired after all
+    }
+    continue;
+   }
+   if(d_events[i].data.ptr == &d_stopFd)
+    continue;
+
+   // Skip tasks that timed out in an earlier round
+   task = (CoTaskXp *)d_events[i].data.ptr;
+   if(task->d_waitFd < 0)
+    continue;
+   task->d_waitFd = -1;
+   makeReady(task, 0);
+  }
+
+  expireTimers();
+ }
+
+ if(read(d_stopFd, &count, sizeof(count)) < 0)
+ {
+  // stop() was not called
+ }
+ __atomic_store_n(&d_stop, 0, __ATOMIC_RELAXED);
+ return 0;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::exitThread
+//==============================================================================
+void CoSchedulerXp::exitThread(void * /*arg*/)
+{
+}
+
+
+//==============================================================================
+// CoSchedulerXp::wait
+//==============================================================================
+int CoSchedulerXp::wait(CoTaskXp *task, int fd, uint32_t events, int64_t deadline)
+{
+ struct epoll_event ev;
+ int op;
+
+ if(fd < 0 && deadline < 0)
+  return EINVAL;
+
+ if(fd >= 0)
+ {
+  ev.events = events | EPOLLONESHOT;
+  ev.data.ptr = task;
+
+  // A task waiting on the same descriptor again only rearms it
+  if(task->d_fd == fd)
+   op = EPOLL_CTL_MOD;
+  else
+  {
+   if(task->d_fd >= 0)
+    epoll_ctl(d_epollFd, EPOLL_CTL_DEL, task->d_fd, &ev);
+   task->d_fd = -1;
+   op = EPOLL_CTL_ADD;
+  }
+  if(epoll_ctl(d_epollFd, op, fd, &ev) != 0)
+   return errno;
+  task->d_fd = fd;
+ }
+
+ task->d_waitFd = fd;
+ if(deadline >= 0)
+ {
+  task->d_deadline = deadline;
+  heapPush(task);
+ }
+ return 0;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::makeReady
+//==============================================================================
+void CoSchedulerXp::makeReady(CoTaskXp *task, int result)
+{
+ if(task->d_heapIndex >= 0)
+  heapRemove(task);
+
+ task->d_coResult = result;
+ task->d_next = NULL;
+ if(d_readyTail != NULL)
+  d_readyTail->d_next = task;
+ else
+  d_readyHead = task;
+ d_readyTail = task;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::runReady
+//==============================================================================
+void CoSchedulerXp::runReady()
+{
+ CoTaskXp *task = d_readyHead;
+ CoTaskXp *next;
+
+ // Tasks made ready by this round run in the next one
+ d_readyHead = NULL;
+ d_readyTail = NULL;
+
+ while(task != NULL)
+ {
+  next = task->d_next;
+  switch(task->step())
+  {
+   case CO_READY:
+    makeReady(task, 0);
+    break;
+   case CO_DONE:
+    finish(task);
+    break;
+   default:
+    break;
+  }
+  task = next;
+ }
+}
+
+
+//==============================================================================
+// CoSchedulerXp::finish
+//==============================================================================
+void CoSchedulerXp::finish(CoTaskXp *task)
+{
+ struct epoll_event ev;
+
+ if(task->d_fd >= 0)
+  epoll_ctl(d_epollFd, EPOLL_CTL_DEL, task->d_fd, &ev);
+ if(task->d_heapIndex >= 0)
+  heapRemove(task);
+ task->d_fd = -1;
+ task->d_waitFd = -1;
+ task->d_done = true;
+ d_numTasks--;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::expireTimers
+//==============================================================================
+void CoSchedulerXp::expireTimers()
+{
+ struct epoll_event ev;
+ int64_t now;
+ CoTaskXp *task;
+
+ if(d_heapSize == 0)
+  return;
+
+ now = DeadlineXp::now().getNanoseconds();
+ while(d_heapSize > 0 && d_heap[0]->d_deadline <= now)
+ {
+  task = d_heap[0];
+  // Its descriptor must not wake it later
+  if(task->d_waitFd >= 0)
+  {
+   epoll_ctl(d_epollFd, EPOLL_CTL_DEL, task->d_fd, &ev);
+   task->d_fd = -1;
+   task->d_waitFd = -1;
+  }
+  makeReady(task, ETIMEDOUT);
+ }
+}
+
+
+//==============================================================================
+// CoSchedulerXp::armTimer
+//==============================================================================
+void CoSchedulerXp::armTimer()
+{
+ struct itimerspec its;
+ int64_t deadline = (d_heapSize > 0) ? d_heap[0]->d_deadline : -1;
+
+ if(deadline == d_armed)
+  return;
+
+ its.it_interval.tv_sec = 0;
+ its.it_interval.tv_nsec = 0;
+ if(deadline < 0)
+ {
+  its.it_value.tv_sec = 0;
+  its.it_value.tv_nsec = 0;
+ }
+ else
+ {
+  // A zero time would disarm it
+  if(deadline == 0)
+   deadline = 1;
+  its.it_value.tv_sec = deadline / DEADLINE_NSEC_PER_SEC;
+  its.it_value.tv_nsec = deadline % DEADLINE_NSEC_PER_SEC;
+ }
+ timerfd_settime(d_timerFd, TFD_TIMER_ABSTIME, &its, NULL);
+ d_armed = (d_heapSize > 0) ? d_heap[0]->d_deadline : -1;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::heapPush
+//==============================================================================
+void CoSchedulerXp::heapPush(CoTaskXp *task)
+{
+ task->d_heapIndex = d_heapSize;
+ d_heap[d_heapSize++] = task;
+ heapUp(task->d_heapIndex);
+}
+
+
+//==============================================================================
+// CoSchedulerXp::heapRemove
+//==============================================================================
+void CoSchedulerXp::heapRemove(CoTaskXp *task)
+{
+ int i = task->d_heapIndex;
+
+ d_heapSize--;
+ if(i != d_heapSize)
+ {
+  heapSwap(i, d_heapSize);
+  heapDown(i);
+  heapUp(i);
+ }
+ task->d_heapIndex = -1;
+}
+
+
+//==============================================================================
+// CoSchedulerXp::heapUp
+//==============================================================================
+void CoSchedulerXp::heapUp(int i)
+{
+ int parent;
+
+ while(i > 0)
+ {
+  parent = (i - 1) / 2;
+  if(d_heap[parent]->d_deadline <= d_heap[i]->d_deadline)
+   break;
+  heapSwap(i, parent);
+  i = parent;
+ }
+}
+
+
+//==============================================================================
+// CoSchedulerXp::heapDown
+//==============================================================================
+void CoSchedulerXp::heapDown(int i)
+{
+ int child;
+
+ for(;;)
+ {
+  child = 2 * i + 1;
+  if(child >= d_heapSize)
+   break;
+  if(child + 1 < d_heapSize &&
+     d_heap[child + 1]->d_deadline < d_heap[child]->d_deadline)
+   child++;
+  if(d_heap[i]->d_deadline <= d_heap[child]->d_deadline)
+   break;
+  heapSwap(i, child);
+  i = child;
+ }
+}
+
+
+//==============================================================================
+// CoSchedulerXp::heapSwap
+//==============================================================================
+void CoSchedulerXp::heapSwap(int a, int b)
+{
+ CoTaskXp *t = d_heap[a];
+
+ d_heap[a] = d_heap[b];
+ d_heap[b] = t;
+ d_heap[a]->d_heapIndex = a;
+ d_heap[b]->d_heapIndex = b;
+}
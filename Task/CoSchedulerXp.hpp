@@ -0,0 +1,323 @@
+//==============================================================================
+// CoSchedulerXp.hpp - Cooperative tasks multiplexed on one thread.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _COSCHEDULERXP_HPP_INCLUDED
+#define _COSCHEDULERXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <sys/epoll.h>
+#include "ThreadXp.hpp"
+#include "DeadlineXp.hpp"
+
+#define CO_MAX_TASKS 256   // Default number of tasks of a scheduler
+#define CO_EPOLL_EVENTS 64 // Descriptor events handled per epoll_wait()
+
+#define CO_READY 0   // step() yielded, run again in the next round
+#define CO_WAITING 1 // step() waits for a descriptor, timer or event
+#define CO_DONE 2    // step() has finished
+
+//------------------------------------------------------------------------------
+// Macros for CoTaskXp::step(). step() is a switch on the line of the last
+// wait (a protothread): every CO_* wait returns from step() and the next
+// call jumps back behind it. Local variables of step() therefore do not
+// keep their values across waits, keep state in members of the task. At
+// most one CO_* macro per source line, and none inside a switch statement
+// of step().
+//------------------------------------------------------------------------------
+
+#define CO_BEGIN() switch(d_coLine) { case 0:
+
+#define CO_END() } d_coLine = -1; return CO_DONE
+
+#define CO_YIELD() \
+ do { d_coLine = __LINE__; return CO_READY; case __LINE__:; } while(0)
+
+// Waits until fd has one of 'events' (EPOLLIN, EPOLLOUT) or the deadline
+// passes. getWaitResult() is 0, ETIMEDOUT, or the errno code that
+// prevented the wait (e.g. EEXIST if another task waits on fd).
+#define CO_WAIT_FD_UNTIL(fd, events, deadline) \
+ do { d_coLine = __LINE__; \
+      if(waitFd((fd), (events), DeadlineXp(deadline).getNanoseconds()) == 0) \
+       return CO_WAITING; \
+      case __LINE__:; } while(0)
+
+#define CO_WAIT_FD(fd, events) \
+ do { d_coLine = __LINE__; \
+      if(waitFd((fd), (events), -1) == 0) \
+       return CO_WAITING; \
+      case __LINE__:; } while(0)
+
+#define CO_SLEEP(timeout) \
+ do { d_coLine = __LINE__; \
+      if(waitFd(-1, 0, DeadlineXp(timeout).getNanoseconds()) == 0) \
+       return CO_WAITING; \
+      case __LINE__:; } while(0)
+
+// Waits until the CoEventXp is set
+#define CO_WAIT_EVENT(event) \
+ while(!(event).isSet()) { d_coLine = __LINE__; (event).wait(this); \
+                           return CO_WAITING; case __LINE__:; }
+
+// Receives from a MessageQueueXp without blocking the thread. 'ret' is
+// the message size, or -1 with the reason in getWaitResult(). Pass a
+// DeadlineXp, a TimeoutXp would be restarted by every wake up.
+#define CO_RECEIVE_UNTIL(mq, buf, size, ret, deadline) \
+ do { d_coResult = 0; \
+      while(((ret) = (mq).try_receive((buf), (size))) < 0 && \
+            (mq).getErrno() == EAGAIN && d_coResult == 0) \
+       CO_WAIT_FD_UNTIL((mq).getDescriptor(), EPOLLIN, (deadline)); \
+      if((ret) >= 0) d_coResult = 0; \
+      else if(d_coResult == 0) d_coResult = (mq).getErrno(); } while(0)
+
+#define CO_RECEIVE(mq, buf, size, ret) \
+ do { d_coResult = 0; \
+      while(((ret) = (mq).try_receive((buf), (size))) < 0 && \
+            (mq).getErrno() == EAGAIN && d_coResult == 0) \
+       CO_WAIT_FD((mq).getDescriptor(), EPOLLIN); \
+      if((ret) >= 0) d_coResult = 0; \
+      else if(d_coResult == 0) d_coResult = (mq).getErrno(); } while(0)
+
+class CoSchedulerXp;
+
+//==============================================================================
+// class CoTaskXp
+//------------------------------------------------------------------------------
+// \brief
+// A lightweight task run by a CoSchedulerXp.
+//
+// Override step() with the body of the task between CO_BEGIN() and
+// CO_END(). The task object is its own frame: the scheduler allocates
+// nothing per task or per wait, and does not own the task.
+//
+// <b>Example:</b>
+// <pre>
+//  class Protocol : public CoTaskXp
+//  {
+//   protected:
+//    virtual int step()
+//    {
+//     CO_BEGIN();
+//     for(;;)
+//     {
+//      CO_RECEIVE(d_queue, d_buf, sizeof(d_buf), d_len);
+//      if(d_len < 0)
+//       break;
+//      ...
+//      CO_SLEEP(TimeoutXp::milliseconds(5));
+//     }
+//     CO_END();
+//    }
+//  };
+// </pre>
+//==============================================================================
+
+class CoTaskXp
+{
+ friend class CoSchedulerXp;
+ friend class CoEventXp;
+ public:
+  CoTaskXp();
+
+  virtual ~CoTaskXp();
+   // The task must not be running when destroyed.
+
+  bool isDone() const;
+   //  return  true if the task has not been spawned or has finished.
+
+ protected:
+  virtual int step() = 0;
+   // Runs the task up to its next wait.
+   //  return  CO_READY, CO_WAITING or CO_DONE, as set by the CO_*
+   //          macros.
+
+  int getWaitResult() const;
+   //  return  result of the last CO_* wait, see CO_WAIT_FD_UNTIL().
+
+  int waitFd(int fd, uint32_t events, int64_t deadline);
+   // Used by the CO_* macros.
+   //  fd        -1 to wait for the deadline only.
+   //  deadline  CLOCK_MONOTONIC ns, -1 for none.
+   //  return  0 if the task now waits, else errno code.
+
+  int d_coLine;
+   // Line of the last wait, 0 before the first step, -1 when done
+
+  int d_coResult;
+
+  //======== END OF INTERFACE ========
+
+ private:
+  CoSchedulerXp *d_scheduler;
+
+  CoTaskXp *d_next;
+   // Ready list or event wait list
+
+  int d_heapIndex;
+   // Position in the timer heap, -1 if not there
+  int64_t d_deadline;
+
+  int d_fd;
+   // Descriptor registered with epoll, -1 if none
+  int d_waitFd;
+   // Descriptor waited for, -1 if none
+
+  bool d_done;
+};
+
+
+//==============================================================================
+// class CoEventXp
+//------------------------------------------------------------------------------
+// \brief
+// An event tasks of one CoSchedulerXp wait for with CO_WAIT_EVENT().
+//
+// set() makes all waiting tasks ready and stays set until reset(). It
+// must be called in the scheduler thread (from a task); other threads
+// reach tasks through descriptors (message queues, eventfd).
+//==============================================================================
+
+class CoEventXp
+{
+ public:
+  CoEventXp();
+
+  void set();
+
+  void reset();
+
+  bool isSet() const;
+
+  void wait(CoTaskXp *task);
+   // Used by CO_WAIT_EVENT().
+
+  //======== END OF INTERFACE ========
+
+ private:
+  bool d_set;
+
+  CoTaskXp *d_waiters;
+};
+
+
+//==============================================================================
+// class CoSchedulerXp
+//------------------------------------------------------------------------------
+// \brief
+// Runs many CoTaskXp on one thread, so state machines that wait for
+// message queues, timers and events do not need a thread each.
+//
+// <ul>
+// <li>The thread waits in epoll_wait() for the descriptors the tasks
+//     wait for, and for one timerfd armed at the earliest task deadline.
+// <li>Ready tasks are run in rounds, in the order they became ready; a
+//     task runs until it waits, so a task that does not wait blocks all
+//     the others.
+// <li>All memory is allocated by the constructor: up to maxTasks tasks
+//     and no allocation per wait.
+// <li>The thread returns when stop() is called or no task is left.
+// <li>Only Linux descriptors can be waited for: message queues of the
+//     Xenomai POSIX skin can not be polled (CO_RECEIVE() throws ENOTSUP
+//     there, from MessageQueueXp::getDescriptor()), and the thread runs
+//     in secondary mode under Xenomai.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  CoSchedulerXp sched(CO_MAX_TASKS, SCHED_FIFO, 60, &cpu2);
+//  for(int i = 0; i < 100; i++)
+//   sched.spawn(&protocols[i]);
+//  sched.run();
+// </pre>
+//==============================================================================
+
+class CoSchedulerXp : public ThreadXp
+{
+ friend class CoTaskXp;
+ friend class CoEventXp;
+ public:
+  CoSchedulerXp(int maxTasks = CO_MAX_TASKS,
+                int policy = SCHED_OTHER,
+                int sched_priority = 0,
+                const cpu_set_t *cpuMask = NULL,
+                const char *name = "co-scheduler");
+   // Throws ZnmException if a descriptor can not be created.
+
+  ~CoSchedulerXp();
+
+  int spawn(CoTaskXp *task);
+   // Adds a task; it runs from the next round. Call before run() or
+   // from a task of this scheduler.
+   //  return  0 on success, EBUSY if the task is already spawned,
+   //          ENOSPC if maxTasks tasks run.
+
+  void stop();
+   // Makes the thread return after the current round. Can be called
+   // from any thread.
+
+  int getTaskCount() const;
+
+ protected:
+  virtual void enterThread(void *arg);
+
+  virtual int executeInThread(void *arg);
+   //  return  0, or errno code if epoll_wait() failed.
+
+  virtual void exitThread(void *arg);
+
+  //======== END OF INTERFACE ========
+
+ private:
+  int wait(CoTaskXp *task, int fd, uint32_t events, int64_t deadline);
+
+  void makeReady(CoTaskXp *task, int result);
+
+  void runReady();
+
+  void finish(CoTaskXp *task);
+
+  void expireTimers();
+
+  void armTimer();
+
+  void heapPush(CoTaskXp *task);
+
+  void heapRemove(CoTaskXp *task);
+
+  void heapUp(int i);
+
+  void heapDown(int i);
+
+  void heapSwap(int a, int b);
+
+  int d_maxTasks;
+  int d_numTasks;
+
+  CoTaskXp *d_readyHead;
+  CoTaskXp *d_readyTail;
+
+  CoTaskXp **d_heap;
+   // Tasks with a deadline, earliest first
+  int d_heapSize;
+
+  int d_epollFd;
+  int d_timerFd;
+  int d_stopFd;
+   // eventfd written by stop()
+
+  int64_t d_armed;
+   // Deadline the timerfd is armed for, -1 if none
+
+  int d_stop;
+
+  struct epoll_event d_events[CO_EPOLL_EVENTS];
+};
+
+#endif // _COSCHEDULERXP_HPP_INCLUDED
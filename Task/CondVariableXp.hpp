@@ -13,6 +13,8 @@
 #include <time.h>
 #include "znmException.hpp"
 #include "MutexXp.hpp"
+#include "DeadlineXp.hpp"
+#include "StopTokenXp.hpp"
 
 //==============================================================================
 // class CondVariableXp
@@ -21,6 +23,8 @@
 // A wrapper for pthread condition variable.
 //
 // <ul>
+// <li>Construct with CLOCK_MONOTONIC to have condTimedWait() with a
+//     DeadlineXp or TimeoutXp unaffected by changes of the system time.
 // <li>This class will throw an exception of type ZnmException in case of
 //     errors.
 // </ul>
@@ -32,29 +36,48 @@
 
 class CondVariableXp {
 public:
-	CondVariableXp (clockid_t cld_id = CLOCK_REALTIME,
+	inline CondVariableXp (clockid_t cld_id = CLOCK_REALTIME,
 					int pshared = PTHREAD_PROCESS_PRIVATE);
 
-	~CondVariableXp ();
+	inline ~CondVariableXp ();
 
-	void condWait(MutexXp *mutex);
+	inline void condWait(MutexXp *mutex);
 
-	int condTimedWait(MutexXp *mutex, const struct timespec *abstime);
+	inline int condTimedWait(MutexXp *mutex, const struct timespec *abstime);
+	// abstime is measured on the clock given to the constructor
 
-	void condSignal();
+	inline int condTimedWait(MutexXp *mutex, const DeadlineXp &deadline);
+	// Converted to the clock given to the constructor
 
-	void condBroadcast();
+	inline int condWait(MutexXp *mutex, StopTokenXp &token);
+	// Like condWait(mutex), but returns -1 (with the mutex held) once a
+	// stop is requested on token, else 0. requestStop() locks the mutex
+	// to wake the waiter, so it must not be called with the mutex held.
+
+	inline void condSignal();
+
+	inline void condBroadcast();
 
 private:
+	static inline void wakeForStop(void *mutex, void *cond);
+
+	static inline void removeStopCallback(MutexXp *mutex, StopTokenXp &token, int id);
+	// Removes the wakeForStop() callback once it is not running
+
 	pthread_cond_t condVar;
     // The mutex object
 
+	clockid_t clockId;
+	// Clock of the absolute wait times
+
 };
 
 // Constructor
 CondVariableXp::CondVariableXp (clockid_t clk_id, int pshared ){
 	pthread_condattr_t attr;
 
+	clockId = clk_id;
+
 	ERROR_CHECK_RET (pthread_condattr_init (&attr), "CondVariableXp", "pthread_condattr_init");
 
 	ERROR_CHECK_RET (pthread_condattr_setclock  (&attr, clk_id), "CondVariableXp", "pthread_condattr_setclock");
@@ -71,13 +94,27 @@ CondVariableXp::~CondVariableXp (){
 }
 
 void CondVariableXp::condWait(MutexXp *mutex){
-	ERROR_CHECK_RET (pthread_cond_wait (&condVar, &(mutex->d_mutex)), "CondVariableXp", "pthread_cond_wait");
+#ifdef ZNM_LOCK_PROFILE
+	LockProfileXp::of(mutex, "MutexXp")->released();
+#endif
+	// A robust mutex may be reacquired from a dead owner
+	ERROR_CHECK_RET (mutex->checkLock(pthread_cond_wait (&condVar, &(mutex->d_mutex)), "pthread_cond_wait"), "CondVariableXp", "pthread_cond_wait");
+#ifdef ZNM_LOCK_PROFILE
+	LockProfileXp::of(mutex, "MutexXp")->acquired(0, false, NULL, true);
+#endif
 }
 
 int CondVariableXp::condTimedWait(MutexXp *mutex, const struct timespec *abstime){
 	int errNumber;
 
-	errNumber = pthread_cond_timedwait (&condVar, &(mutex->d_mutex), abstime);
+#ifdef ZNM_LOCK_PROFILE
+	LockProfileXp::of(mutex, "MutexXp")->released();
+#endif
+	errNumber = mutex->checkLock(pthread_cond_timedwait (&condVar, &(mutex->d_mutex), abstime), "pthread_cond_timedwait");
+#ifdef ZNM_LOCK_PROFILE
+	if (errNumber == 0 || errNumber == ETIMEDOUT)
+		LockProfileXp::of(mutex, "MutexXp")->acquired(0, false, NULL, true);
+#endif
 
 	if (errNumber == 0)
 		return 0;
@@ -86,6 +123,51 @@ int CondVariableXp::condTimedWait(MutexXp *mutex, const struct timespec *abstime
 	throw(ZnmException( "CondVariableXp", "pthread_cond_timedwait", errNumber));
 }
 
+int CondVariableXp::condTimedWait(MutexXp *mutex, const DeadlineXp &deadline){
+	struct timespec abstime;
+
+	deadline.toTimespec(clockId, &abstime);
+	return condTimedWait(mutex, &abstime);
+}
+
+int CondVariableXp::condWait(MutexXp *mutex, StopTokenXp &token){
+	int id;
+
+	// Registered before the check, so a stop requested in between
+	// still finds the waiter
+	id = token.addCallback(CondVariableXp::wakeForStop, mutex, this);
+	if (id < 0)
+		throw(ZnmException( "CondVariableXp", "addCallback", ENOSPC));
+
+	try {
+		if (!token.stopRequested())
+			condWait(mutex);
+	} catch (...) {
+		removeStopCallback(mutex, token, id);
+		throw;
+	}
+
+	removeStopCallback(mutex, token, id);
+	return token.stopRequested() ? -1 : 0;
+}
+
+void CondVariableXp::wakeForStop(void *mutex, void *cond){
+	// Holding the mutex, the waiter is either before its check or waiting
+	((MutexXp *)mutex)->lock();
+	((CondVariableXp *)cond)->condBroadcast();
+	((MutexXp *)mutex)->unlock();
+}
+
+void CondVariableXp::removeStopCallback(MutexXp *mutex, StopTokenXp &token, int id){
+	// A running wakeForStop() waits for the mutex we hold, let it finish
+	// before returning, the caller may destroy the mutex or this object
+	if (!token.tryRemoveCallback(id)) {
+		mutex->unlock();
+		token.removeCallback(id);
+		mutex->lock();
+	}
+}
+
 void CondVariableXp::condSignal() {
 	ERROR_CHECK_RET ( pthread_cond_signal (&condVar), "CondVariableXp", " pthread_cond_signal");
 }
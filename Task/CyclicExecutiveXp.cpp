@@ -0,0 +1,366 @@
+//==============================================================================
+// CyclicExecutiveXp.cpp - Table driven scheduler for periodic activities.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "CyclicExecutiveXp.hpp"
+#include "znmException.hpp"
+#include <algorithm>
+#include <functional>
+#include <string.h>
+
+//==============================================================================
+// class CyclicExecutiveXp::FrameThread
+//==============================================================================
+class CyclicExecutiveXp::FrameThread : public PeriodicThreadXp
+{
+ public:
+  FrameThread(CyclicExecutiveXp *exec, int policy, int sched_priority,
+              const cpu_set_t *cpuMask)
+   : PeriodicThreadXp(TimeoutXp(exec->d_minorFrame), policy, sched_priority,
+                      "cyclic-exec", cpuMask),
+     d_exec(exec) {}
+
+ protected:
+  virtual int executeCycle(void * /*arg*/)
+  {
+   d_exec->runFrame();
+   return 0;
+  }
+
+  virtual void overrun(uint64_t missed)
+  {
+   d_exec->frameOverrun(missed);
+  }
+
+ private:
+  CyclicExecutiveXp *d_exec;
+};
+
+
+//==============================================================================
+// CyclicExecutiveXp::CyclicExecutiveXp
+//==============================================================================
+CyclicExecutiveXp::CyclicExecutiveXp()
+{
+ d_minorFrame = 0;
+ d_majorFrame = 0;
+ d_frame = 0;
+ d_frameOverruns = 0;
+ d_thread = NULL;
+ d_running = false;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::~CyclicExecutiveXp
+//==============================================================================
+CyclicExecutiveXp::~CyclicExecutiveXp()
+{
+ stop();
+ delete d_thread;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::addTask
+//==============================================================================
+int CyclicExecutiveXp::addTask(CyclicTaskXp *task, const TimeoutXp &period,
+                               const TimeoutXp &wcet)
+{
+ Task t;
+
+ if(d_running)
+  throw ZnmException("CyclicExecutiveXp", "addTask", EBUSY);
+ if(task == NULL || period.getNanoseconds() <= 0 ||
+    wcet.getNanoseconds() <= 0 || wcet.getNanoseconds() > period.getNanoseconds())
+  throw ZnmException("CyclicExecutiveXp", "addTask", EINVAL);
+
+ t.task = task;
+ t.period = period.getNanoseconds();
+ t.wcet = wcet.getNanoseconds();
+ t.budgetOverruns = 0;
+ d_tasks.push_back(t);
+
+ // The table has to be built again
+ d_table.clear();
+ d_minorFrame = 0;
+ d_majorFrame = 0;
+ return d_tasks.size() - 1;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::build
+//==============================================================================
+int CyclicExecutiveXp::build()
+{
+ std::vector<int64_t> candidates;
+ int64_t major = 1;
+ int64_t maxWcet = 0;
+
+ if(d_tasks.empty())
+  return EINVAL;
+
+ for(size_t i = 0; i < d_tasks.size(); i++)
+ {
+  // A major frame past 64 bits has far more than CYCLIC_MAX_FRAMES frames
+  if(__builtin_mul_overflow(major / gcd(major, d_tasks[i].period),
+                            d_tasks[i].period, &major))
+   return EINVAL;
+  if(d_tasks[i].wcet > maxWcet)
+   maxWcet = d_tasks[i].wcet;
+
+  // The minor frame has to divide one of the periods
+  for(int64_t d = 1; d * d <= d_tasks[i].period; d++)
+  {
+   if(d_tasks[i].period % d != 0)
+    continue;
+   candidates.push_back(d);
+   candidates.push_back(d_tasks[i].period / d);
+  }
+ }
+
+ std::sort(candidates.begin(), candidates.end(), std::greater<int64_t>());
+ candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+ d_majorFrame = major;
+ for(size_t i = 0; i < candidates.size(); i++)
+ {
+  if(candidates[i] < maxWcet)
+   break;
+  if(major / candidates[i] > CYCLIC_MAX_FRAMES)
+   break;
+  if(fitsConstraints(candidates[i]) && buildTable(candidates[i]))
+  {
+   d_minorFrame = candidates[i];
+   d_frame = 0;
+   return 0;
+  }
+ }
+
+ d_table.clear();
+ d_majorFrame = 0;
+ return EINVAL;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::start
+//==============================================================================
+int CyclicExecutiveXp::start(int policy /*= SCHED_OTHER*/,
+                             int sched_priority /*= 0*/,
+                             const cpu_set_t *cpuMask /*= NULL*/)
+{
+ int code;
+
+ if(d_running)
+  return EBUSY;
+ if(d_table.empty())
+ {
+  code = build();
+  if(code != 0)
+   return code;
+ }
+
+ // The thread of a previous run is kept until now for getStats()
+ delete d_thread;
+ d_frame = 0;
+ d_thread = new FrameThread(this, policy, sched_priority, cpuMask);
+ code = d_thread->run();
+ d_running = (code == 0);
+ return code;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::stop
+//==============================================================================
+void CyclicExecutiveXp::stop()
+{
+ if(!d_running)
+  return;
+
+ d_thread->stop();
+ d_thread->join();
+ d_running = false;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getMinorFrame
+//==============================================================================
+TimeoutXp CyclicExecutiveXp::getMinorFrame() const
+{
+ return TimeoutXp(d_minorFrame);
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getMajorFrame
+//==============================================================================
+TimeoutXp CyclicExecutiveXp::getMajorFrame() const
+{
+ return TimeoutXp(d_majorFrame);
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getFrameCount
+//==============================================================================
+int CyclicExecutiveXp::getFrameCount() const
+{
+ return d_table.size();
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getFrameOverruns
+//==============================================================================
+uint64_t CyclicExecutiveXp::getFrameOverruns()
+{
+ return __atomic_load_n(&d_frameOverruns, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getBudgetOverruns
+//==============================================================================
+uint64_t CyclicExecutiveXp::getBudgetOverruns(int task)
+{
+ if(task < 0 || task >= (int)d_tasks.size())
+  return 0;
+ return __atomic_load_n(&d_tasks[task].budgetOverruns, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::getStats
+//==============================================================================
+void CyclicExecutiveXp::getStats(PeriodicStatsXp *stats)
+{
+ if(d_thread != NULL)
+  d_thread->getStats(stats);
+ else
+  memset(stats, 0, sizeof(*stats));
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::earlierDeadline
+//==============================================================================
+bool CyclicExecutiveXp::earlierDeadline(const Job &a, const Job &b)
+{
+ if(a.deadline != b.deadline)
+  return a.deadline < b.deadline;
+ return a.release < b.release;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::gcd
+//==============================================================================
+int64_t CyclicExecutiveXp::gcd(int64_t a, int64_t b)
+{
+ int64_t t;
+
+ while(b != 0)
+ {
+  t = a % b;
+  a = b;
+  b = t;
+ }
+ return a;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::fitsConstraints
+//==============================================================================
+bool CyclicExecutiveXp::fitsConstraints(int64_t frame)
+{
+ // A whole frame lies between every release and its deadline
+ for(size_t i = 0; i < d_tasks.size(); i++)
+  if(2 * frame - gcd(d_tasks[i].period, frame) > d_tasks[i].period)
+   return false;
+ return true;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::buildTable
+//==============================================================================
+bool CyclicExecutiveXp::buildTable(int64_t frame)
+{
+ int frames = d_majorFrame / frame;
+ std::vector<int64_t> room(frames, frame);
+ std::vector<Job> jobs;
+ Job job;
+ int first, last, f;
+
+ for(size_t i = 0; i < d_tasks.size(); i++)
+ {
+  for(int64_t r = 0; r < d_majorFrame; r += d_tasks[i].period)
+  {
+   job.release = r;
+   job.deadline = r + d_tasks[i].period;
+   job.task = i;
+   jobs.push_back(job);
+  }
+ }
+ std::sort(jobs.begin(), jobs.end(), earlierDeadline);
+
+ d_table.assign(frames, std::vector<int>());
+ for(size_t j = 0; j < jobs.size(); j++)
+ {
+  first = (jobs[j].release + frame - 1) / frame;
+  last = jobs[j].deadline / frame - 1;
+  for(f = first; f <= last; f++)
+   if(room[f] >= d_tasks[jobs[j].task].wcet)
+    break;
+  if(f > last)
+   return false;
+
+  room[f] -= d_tasks[jobs[j].task].wcet;
+  d_table[f].push_back(jobs[j].task);
+ }
+ return true;
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::runFrame
+//==============================================================================
+void CyclicExecutiveXp::runFrame()
+{
+ std::vector<int> &tasks = d_table[d_frame];
+ int64_t start, end;
+
+ for(size_t i = 0; i < tasks.size(); i++)
+ {
+  Task &t = d_tasks[tasks[i]];
+
+  start = DeadlineXp::now().getNanoseconds();
+  t.task->execute();
+  end = DeadlineXp::now().getNanoseconds();
+
+  if(end - start > t.wcet)
+   __atomic_add_fetch(&t.budgetOverruns, 1, __ATOMIC_RELAXED);
+ }
+
+ d_frame = (d_frame + 1) % d_table.size();
+}
+
+
+//==============================================================================
+// CyclicExecutiveXp::frameOverrun
+//==============================================================================
+void CyclicExecutiveXp::frameOverrun(uint64_t missed)
+{
+ // Stay aligned with time: the skipped frames are not run late
+ __atomic_add_fetch(&d_frameOverruns, missed, __ATOMIC_RELAXED);
+ d_frame = (d_frame + missed) % d_table.size();
+}
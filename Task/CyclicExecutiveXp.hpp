@@ -0,0 +1,166 @@
+//==============================================================================
+// CyclicExecutiveXp.hpp - Table driven scheduler for periodic activities.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _CYCLICEXECUTIVEXP_HPP_INCLUDED
+#define _CYCLICEXECUTIVEXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+#include <vector>
+#include "PeriodicThreadXp.hpp"
+#include "DeadlineXp.hpp"
+
+#define CYCLIC_MAX_FRAMES 4096 // Largest frame table (minor frames per major frame)
+
+//==============================================================================
+// class CyclicTaskXp
+//------------------------------------------------------------------------------
+// \brief
+// An activity run by CyclicExecutiveXp. Override execute() with one
+// activation of the activity; it must not block.
+//==============================================================================
+
+class CyclicTaskXp
+{
+ public:
+  virtual ~CyclicTaskXp() {}
+
+  virtual void execute() = 0;
+   // One activation, runs in the executive thread
+};
+
+
+//==============================================================================
+// class CyclicExecutiveXp
+//------------------------------------------------------------------------------
+// \brief
+// Runs many small periodic activities from one thread, following a frame
+// table built before start, instead of a thread per activity.
+//
+// <ul>
+// <li>The major frame is the least common multiple of the task periods.
+//     It is divided into minor frames of equal length; the minor frame is
+//     the largest one that is at least the longest WCET, divides one of
+//     the periods and satisfies 2f - gcd(period, f) <= period for every
+//     task (Baker and Shaw), so every job has a whole frame between its
+//     release and its deadline.
+// <li>Jobs (task activations in one major frame) are placed earliest
+//     deadline first into the first frame, between release and deadline,
+//     that still has room for the WCET. If that fails the next smaller
+//     minor frame is tried.
+// <li>The thread runs at the minor frame period (see PeriodicThreadXp).
+//     A frame whose tasks run past the next frame start is a frame
+//     overrun: the frames it ran into are skipped. A task running longer
+//     than its WCET is a budget overrun. Both are counted.
+// <li>Tasks are added before start(); the table can not change while
+//     running.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  CyclicExecutiveXp exec;
+//  exec.addTask(&control, TimeoutXp::milliseconds(10), TimeoutXp::microseconds(500));
+//  exec.addTask(&logger, TimeoutXp::milliseconds(100), TimeoutXp::milliseconds(2));
+//  exec.start(SCHED_FIFO, 70, &cpu3);
+// </pre>
+//==============================================================================
+
+class CyclicExecutiveXp
+{
+ public:
+  CyclicExecutiveXp();
+
+  ~CyclicExecutiveXp();
+   // Stops the executive.
+
+  int addTask(CyclicTaskXp *task, const TimeoutXp &period, const TimeoutXp &wcet);
+   // Adds a task with deadline equal to its period. Throws ZnmException
+   // with EINVAL for a bad period or WCET and EBUSY once started.
+   //  return  index of the task, for getBudgetOverruns().
+
+  int build();
+   // Builds the frame table. Called by start() if needed.
+   //  return  0 on success, EINVAL if no table fits the tasks.
+
+  int start(int policy = SCHED_OTHER, int sched_priority = 0,
+            const cpu_set_t *cpuMask = NULL);
+   // Builds the table and starts the executive thread.
+   //  return  0 on success, and errno code on error.
+
+  void stop();
+   // Stops the thread after the current frame and joins it. The
+   // counters and statistics stay readable.
+
+  TimeoutXp getMinorFrame() const;
+
+  TimeoutXp getMajorFrame() const;
+
+  int getFrameCount() const;
+   //  return  minor frames per major frame, 0 before build().
+
+  uint64_t getFrameOverruns();
+   //  return  number of minor frames skipped because a frame overran.
+
+  uint64_t getBudgetOverruns(int task);
+   //  return  activations of the task that ran longer than its WCET.
+
+  void getStats(PeriodicStatsXp *stats);
+   // Release jitter and execution time per minor frame, of the
+   // current or last run.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  class FrameThread;
+
+  struct Task
+  {
+   CyclicTaskXp *task;
+   int64_t period;
+   int64_t wcet;
+   uint64_t budgetOverruns;
+  };
+
+  struct Job
+  {
+   int64_t release;
+   int64_t deadline;
+   int task;
+  };
+
+  static bool earlierDeadline(const Job &a, const Job &b);
+
+  static int64_t gcd(int64_t a, int64_t b);
+
+  bool fitsConstraints(int64_t frame);
+
+  bool buildTable(int64_t frame);
+
+  void runFrame();
+
+  void frameOverrun(uint64_t missed);
+
+  std::vector<Task> d_tasks;
+
+  std::vector< std::vector<int> > d_table;
+   // Task indices to run in each minor frame, in order
+
+  int64_t d_minorFrame;
+  int64_t d_majorFrame;
+  int d_frame;
+   // Next minor frame to run
+
+  uint64_t d_frameOverruns;
+
+  FrameThread *d_thread;
+
+  bool d_running;
+};
+
+#endif // _CYCLICEXECUTIVEXP_HPP_INCLUDED
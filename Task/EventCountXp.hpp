@@ -0,0 +1,180 @@
+//==============================================================================
+// EventCountXp.hpp - Eventcount for blocking on lock-free structures.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _EVENTCOUNTXP_HPP_INCLUDED
+#define _EVENTCOUNTXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <limits.h>
+#include <inttypes.h>
+#include "FutexXp.hpp"
+#include "znmException.hpp"
+
+//==============================================================================
+// class EventCountXp
+//------------------------------------------------------------------------------
+// \brief
+// Lets consumers of a lock-free structure (e.g. a ring buffer) sleep
+// until a producer makes progress, without a mutex. A condition
+// variable for conditions that are checked without a lock.
+//
+// <ul>
+// <li>A consumer that found nothing to do announces itself with
+//     prepareWait(), checks the condition again, and then either
+//     cancelWait()s (condition became true) or commitWait()s (sleeps
+//     until a notify() that happened after prepareWait()).
+// <li>A producer calls notify() after publishing. If nobody is waiting
+//     this costs one memory fence and one load, no read-modify-write
+//     and no system call.
+// <li>Can be placed in shared memory with pshared set to
+//     PTHREAD_PROCESS_SHARED.
+// <li>This class will throw an exception of type ZnmException in case of
+//     errors.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  // consumer                          // producer
+//  while(!ring.pop(&item))              ring.push(item);
+//  {                                    ec.notify();
+//   uint32_t key = ec.prepareWait();
+//   if(ring.pop(&item))
+//   {
+//    ec.cancelWait();
+//    break;
+//   }
+//   ec.commitWait(key);
+//  }
+// </pre>
+//==============================================================================
+
+class EventCountXp
+{
+ public:
+  inline EventCountXp(int pshared = PTHREAD_PROCESS_PRIVATE);
+   // Constructs an EventCountXp
+
+  inline uint32_t prepareWait();
+   // Registers the caller as a waiter. Check the condition again
+   // after this call, then call cancelWait() or commitWait().
+   //  return  key to pass to commitWait()
+
+  inline void cancelWait();
+   // Unregisters a waiter that does not need to sleep anymore.
+
+  inline void commitWait(uint32_t key);
+   // Sleeps until notify() or notifyAll() is called after the
+   // prepareWait() that returned key. Returns at once if one
+   // already was.
+
+  inline void notify();
+   // Wakes one waiter.
+
+  inline void notifyAll();
+   // Wakes all waiters.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  inline void doNotify(int n);
+
+  uint32_t d_epoch;
+   // Incremented by every notify() that finds waiters, futex word
+
+  uint32_t d_waiters;
+   // Threads between prepareWait() and commit/cancelWait()
+
+  bool d_pshared;
+};
+
+
+//==============================================================================
+// EventCountXp::EventCountXp()
+//==============================================================================
+EventCountXp::EventCountXp(int pshared /*= PTHREAD_PROCESS_PRIVATE*/)
+{
+ d_epoch = 0;
+ d_waiters = 0;
+ d_pshared = (pshared == PTHREAD_PROCESS_SHARED);
+}
+
+
+//==============================================================================
+// EventCountXp::prepareWait()
+//==============================================================================
+uint32_t EventCountXp::prepareWait()
+{
+ // Ordered before the caller re-checks its condition
+ __atomic_add_fetch(&d_waiters, 1, __ATOMIC_SEQ_CST);
+ return __atomic_load_n(&d_epoch, __ATOMIC_ACQUIRE);
+}
+
+
+//==============================================================================
+// EventCountXp::cancelWait()
+//==============================================================================
+void EventCountXp::cancelWait()
+{
+ __atomic_sub_fetch(&d_waiters, 1, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// EventCountXp::commitWait(uint32_t key)
+//==============================================================================
+void EventCountXp::commitWait(uint32_t key)
+{
+ int errNumber;
+
+ while(__atomic_load_n(&d_epoch, __ATOMIC_ACQUIRE) == key)
+ {
+  errNumber = futexWait(&d_epoch, key, NULL, CLOCK_MONOTONIC, d_pshared);
+  if(errNumber != 0 && errNumber != EAGAIN && errNumber != EINTR)
+  {
+   cancelWait();
+   throw(ZnmException("EventCountXp", "futex_wait", errNumber));
+  }
+ }
+ cancelWait();
+}
+
+
+//==============================================================================
+// EventCountXp::notify()
+//==============================================================================
+void EventCountXp::notify()
+{
+ doNotify(1);
+}
+
+
+//==============================================================================
+// EventCountXp::notifyAll()
+//==============================================================================
+void EventCountXp::notifyAll()
+{
+ doNotify(INT_MAX);
+}
+
+
+//==============================================================================
+// EventCountXp::doNotify(int n)
+//==============================================================================
+void EventCountXp::doNotify(int n)
+{
+ // Orders the caller's publish before reading d_waiters; pairs with
+ // the increment in prepareWait()
+ __atomic_thread_fence(__ATOMIC_SEQ_CST);
+ if(__atomic_load_n(&d_waiters, __ATOMIC_RELAXED) == 0)
+  return;
+
+ __atomic_add_fetch(&d_epoch, 1, __ATOMIC_SEQ_CST);
+ futexWake(&d_epoch, n, d_pshared);
+}
+
+#endif // _EVENTCOUNTXP_HPP_INCLUDED
@@ -0,0 +1,232 @@
+//==============================================================================
+// FutexMutexXp.hpp - Futex based mutex with adaptive spinning.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _FUTEXMUTEXXP_HPP_INCLUDED
+#define _FUTEXMUTEXXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <time.h>
+#include <inttypes.h>
+#include "FutexXp.hpp"
+#include "DeadlineXp.hpp"
+#include "znmException.hpp"
+
+#define FUTEX_MUTEX_SPIN 100 // Default number of spins before sleeping
+
+//==============================================================================
+// class FutexMutexXp
+//------------------------------------------------------------------------------
+// \brief
+// A mutex for very short critical sections, with the same lock(),
+// unlock(), tryLock() and timedLock() interface as MutexXp.
+//
+// <ul>
+// <li>Locking and unlocking an uncontended mutex is a single atomic
+//     instruction each, no system call.
+// <li>A contended lock() spins up to spinCount times waiting for the
+//     owner to leave, and only then sleeps in the kernel (futex). Tune
+//     spinCount to the length of the critical section; 0 disables
+//     spinning.
+// <li>Not recursive and no priority inheritance. Use MutexXp with
+//     PTHREAD_PRIO_INHERIT where inversion matters.
+// <li>Can be placed in shared memory with pshared set to
+//     PTHREAD_PROCESS_SHARED.
+// <li>This class will throw an exception of type ZnmException in case of
+//     errors.
+// </ul>
+//==============================================================================
+
+class FutexMutexXp
+{
+ public:
+  inline FutexMutexXp(int spinCount = FUTEX_MUTEX_SPIN,
+                      int pshared = PTHREAD_PROCESS_PRIVATE);
+   // Constructs a FutexMutexXp
+
+  inline void lock();
+   // Locks the mutex. If it is locked by another thread, spins for a
+   // while and then blocks until the mutex gets unlocked.
+
+  inline void unlock();
+   // Unlocks the mutex, waking one sleeping thread if there is any.
+
+  inline int tryLock();
+   // Returns 0 and locks the mutex if it is not already locked,
+   // else returns -1.
+
+  inline int timedLock(const struct timespec *to);
+   // Like lock(), but gives up at the absolute CLOCK_REALTIME time
+   // 'to' and returns -1. Returns 0 if the mutex was locked.
+
+  inline int timedLock(const DeadlineXp &deadline);
+   // Like timedLock(), with a CLOCK_MONOTONIC deadline or a TimeoutXp.
+
+  inline void setSpinCount(int spinCount);
+
+  inline int getSpinCount() const;
+
+  //======== END OF INTERFACE ========
+
+ private:
+  inline bool spin();
+   // Spins while the mutex is held, returns true if it got the lock.
+
+  inline int lockSlow(const struct timespec *to, clockid_t clk_id);
+
+  uint32_t d_state;
+   // 0: unlocked, 1: locked, 2: locked and there may be sleepers
+
+  int d_spinCount;
+
+  bool d_pshared;
+};
+
+
+//==============================================================================
+// FutexMutexXp::FutexMutexXp()
+//==============================================================================
+FutexMutexXp::FutexMutexXp(int spinCount /*= FUTEX_MUTEX_SPIN*/,
+                           int pshared /*= PTHREAD_PROCESS_PRIVATE*/)
+{
+ d_state = 0;
+ d_spinCount = (spinCount < 0) ? 0 : spinCount;
+ d_pshared = (pshared == PTHREAD_PROCESS_SHARED);
+}
+
+
+//==============================================================================
+// FutexMutexXp::lock()
+//==============================================================================
+void FutexMutexXp::lock()
+{
+ uint32_t expected = 0;
+
+ if(__atomic_compare_exchange_n(&d_state, &expected, 1, false,
+                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  return;
+ lockSlow(NULL, CLOCK_MONOTONIC);
+}
+
+
+//==============================================================================
+// FutexMutexXp::unlock()
+//==============================================================================
+void FutexMutexXp::unlock()
+{
+ // 1 -> 0 is the uncontended case, 2 means someone may be sleeping
+ if(__atomic_fetch_sub(&d_state, 1, __ATOMIC_RELEASE) != 1)
+ {
+  __atomic_store_n(&d_state, 0, __ATOMIC_RELEASE);
+  futexWake(&d_state, 1, d_pshared);
+ }
+}
+
+
+//==============================================================================
+// FutexMutexXp::tryLock()
+//==============================================================================
+int FutexMutexXp::tryLock()
+{
+ uint32_t expected = 0;
+
+ if(__atomic_compare_exchange_n(&d_state, &expected, 1, false,
+                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  return 0;
+ return -1;
+}
+
+
+//==============================================================================
+// FutexMutexXp::timedLock(const struct timespec *to)
+//==============================================================================
+int FutexMutexXp::timedLock(const struct timespec *to)
+{
+ if(tryLock() == 0)
+  return 0;
+ return lockSlow(to, CLOCK_REALTIME);
+}
+
+
+//==============================================================================
+// FutexMutexXp::timedLock(const DeadlineXp &deadline)
+//==============================================================================
+int FutexMutexXp::timedLock(const DeadlineXp &deadline)
+{
+ struct timespec to;
+
+ if(tryLock() == 0)
+  return 0;
+ deadline.toTimespec(CLOCK_MONOTONIC, &to);
+ return lockSlow(&to, CLOCK_MONOTONIC);
+}
+
+
+//==============================================================================
+// FutexMutexXp::setSpinCount(int spinCount)
+//==============================================================================
+void FutexMutexXp::setSpinCount(int spinCount)
+{
+ d_spinCount = (spinCount < 0) ? 0 : spinCount;
+}
+
+
+//==============================================================================
+// FutexMutexXp::getSpinCount()
+//==============================================================================
+int FutexMutexXp::getSpinCount() const
+{
+ return d_spinCount;
+}
+
+
+//==============================================================================
+// FutexMutexXp::spin()
+//==============================================================================
+bool FutexMutexXp::spin()
+{
+ uint32_t expected;
+
+ for(int i = 0; i < d_spinCount; i++)
+ {
+  // Read only while held, so the cache line is not bounced
+  if(__atomic_load_n(&d_state, __ATOMIC_RELAXED) == 0)
+  {
+   expected = 0;
+   if(__atomic_compare_exchange_n(&d_state, &expected, 1, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return true;
+  }
+  cpuRelax();
+ }
+ return false;
+}
+
+
+//==============================================================================
+// FutexMutexXp::lockSlow(const struct timespec *to, clockid_t clk_id)
+//==============================================================================
+int FutexMutexXp::lockSlow(const struct timespec *to, clockid_t clk_id)
+{
+ int errNumber;
+
+ if(spin())
+  return 0;
+
+ // Mark contended; whoever sees 0 here owns the lock
+ while(__atomic_exchange_n(&d_state, 2, __ATOMIC_ACQUIRE) != 0)
+ {
+  errNumber = futexWait(&d_state, 2, to, clk_id, d_pshared);
+  if(errNumber == ETIMEDOUT)
+   return -1;
+  if(errNumber != 0 && errNumber != EAGAIN && errNumber != EINTR)
+   throw(ZnmException("FutexMutexXp", "futex_wait", errNumber));
+ }
+ return 0;
+}
+
+#endif // _FUTEXMUTEXXP_HPP_INCLUDED
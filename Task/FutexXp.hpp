@@ -0,0 +1,98 @@
+//==============================================================================
+// FutexXp.hpp - Futex system call and spin helpers.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _FUTEXXP_HPP_INCLUDED
+#define _FUTEXXP_HPP_INCLUDED
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <inttypes.h>
+
+//==============================================================================
+// Futex helpers
+//------------------------------------------------------------------------------
+// \brief
+// Thin wrappers over the futex(2) system call used by the futex based
+// synchronization classes.
+//
+// <ul>
+// <li>A futex word that lives in shared memory and is used by several
+//     processes must be waited on and woken with pshared = true.
+// <li>These calls enter the Linux kernel. Under Xenomai they cause a
+//     switch to secondary mode, so use them only where the fast path
+//     (no system call) is the common case.
+// </ul>
+//==============================================================================
+
+inline int futexWait(uint32_t *addr, uint32_t val,
+                     const struct timespec *abstime = NULL,
+                     clockid_t clk_id = CLOCK_MONOTONIC,
+                     bool pshared = false);
+ // Sleeps while *addr == val, until woken or until the absolute time
+ // abstime (measured on clk_id) has passed.
+ //  return  0 when woken, EAGAIN if *addr != val, ETIMEDOUT or EINTR.
+
+inline int futexWake(uint32_t *addr, int n, bool pshared = false);
+ // Wakes at most n threads sleeping on addr.
+ //  return  number of threads woken.
+
+inline void cpuRelax();
+ // Tells the CPU we are in a spin loop (PAUSE on x86).
+
+
+//==============================================================================
+// futexWait()
+//==============================================================================
+int futexWait(uint32_t *addr, uint32_t val, const struct timespec *abstime,
+              clockid_t clk_id, bool pshared)
+{
+ int op = FUTEX_WAIT_BITSET;
+
+ if(!pshared)
+  op |= FUTEX_PRIVATE_FLAG;
+ if(abstime != NULL && clk_id == CLOCK_REALTIME)
+  op |= FUTEX_CLOCK_REALTIME;
+
+ if(syscall(SYS_futex, addr, op, val, abstime, NULL, FUTEX_BITSET_MATCH_ANY) == -1)
+  return errno;
+ return 0;
+}
+
+
+//==============================================================================
+// futexWake()
+//==============================================================================
+int futexWake(uint32_t *addr, int n, bool pshared)
+{
+ int op = FUTEX_WAKE;
+
+ if(!pshared)
+  op |= FUTEX_PRIVATE_FLAG;
+
+ return syscall(SYS_futex, addr, op, n, NULL, NULL, 0);
+}
+
+
+//==============================================================================
+// cpuRelax()
+//==============================================================================
+void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+ __builtin_ia32_pause();
+#elif defined(__arm__) || defined(__aarch64__)
+ __asm__ __volatile__("yield" ::: "memory");
+#else
+ __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+#endif // _FUTEXXP_HPP_INCLUDED
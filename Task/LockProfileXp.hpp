@@ -0,0 +1,445 @@
+//==============================================================================
+// LockProfileXp.hpp - Lock contention statistics for instrumented builds.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _LOCKPROFILEXP_HPP_INCLUDED
+#define _LOCKPROFILEXP_HPP_INCLUDED
+
+//==============================================================================
+// Building with -DZNM_LOCK_PROFILE makes MutexXp and RWLock record, per
+// lock object:
+// <ul>
+// <li>number of acquisitions and of contended acquisitions (the lock was
+//     not free on the first try),
+// <li>histogram of time spent waiting for contended acquisitions,
+// <li>histogram of time the lock was held exclusively (MutexXp, and RWLock
+//     write locks),
+// <li>the code addresses that hit contention most often. Resolve them
+//     with 'addr2line -f -C -e <program> <address>'.
+// </ul>
+// Call LockProfileXp::dumpAll() at any time to print all live locks.
+// Without ZNM_LOCK_PROFILE nothing is recorded.
+//
+// The statistics live in a table of the process, keyed by the address of
+// the lock, not in the lock: the locks have the same size and layout in
+// every build, so processes built with and without ZNM_LOCK_PROFILE can
+// share a lock in shared memory. Such a lock is listed by every process
+// that used it, with the acquisitions of that process only. Beyond
+// LOCK_PROFILE_LOCKS live locks the statistics are summed in one entry.
+//==============================================================================
+
+#ifdef ZNM_LOCK_PROFILE
+
+#include <pthread.h>
+#include <time.h>
+#include <inttypes.h>
+#include <ostream>
+#include <iomanip>
+
+#define LOCK_PROFILE_NOINLINE __attribute__((noinline))
+ // Keeps __builtin_return_address(0) pointing at the caller of lock()
+
+#define LOCK_PROFILE_BUCKETS 32 // Bucket i counts times in [2^i, 2^(i+1)) ns
+#define LOCK_PROFILE_SITES 8    // Number of contending call sites kept
+#define LOCK_PROFILE_LOCKS 256  // Locks profiled per process, a power of two
+
+class LockProfileXp
+{
+ public:
+  static inline LockProfileXp *of(const void *lock, const char *kind);
+   // Statistics of the lock at 'lock', created on first use.
+   //  kind  Printed by dump(), a string literal.
+
+  static inline void forget(const void *lock);
+   // Call from the destructor of the lock, a later lock at this
+   // address starts from zero.
+
+  inline void setName(const char *name);
+   // Name printed by dump(), the address of the lock is used if NULL.
+
+  static inline uint64_t now();
+   // CLOCK_MONOTONIC in nanoseconds
+
+  inline void acquired(uint64_t waitStart, bool contended, void *site, bool exclusive);
+   // Call after the lock is taken. waitStart is now() taken before
+   // blocking, only used if contended.
+
+  inline void released();
+   // Call before the lock is released. Records a hold time if it was
+   // acquired exclusively.
+
+  inline void reset();
+
+  inline void dump(std::ostream &out) const;
+
+  static inline void dumpAll(std::ostream &out);
+   // Prints statistics of every live lock.
+
+  static inline void resetAll();
+
+  //======== END OF INTERFACE ========
+
+ private:
+  struct Site
+  {
+   void *address;
+   uint64_t count;
+  };
+
+  static inline pthread_mutex_t *registryLock();
+
+  static inline LockProfileXp *table();
+   // LOCK_PROFILE_LOCKS entries, open addressing, and one for the
+   // locks that did not fit
+
+  static inline uint32_t hash(const void *lock);
+
+  static inline bool isLive(const void *key);
+
+  static inline int bucket(uint64_t ns);
+
+  static inline void dumpHistogram(std::ostream &out, const char *title, const uint64_t *hist);
+
+  const void *d_lock;
+   // Key of the entry: NULL if never used, the overflow entry if
+   // forgotten
+  const char *d_kind;
+  const char *d_name;
+
+  uint64_t d_acquisitions;
+  uint64_t d_contended;
+  uint64_t d_holdStart;
+  bool d_exclusive;
+   // Hold of the last acquisition is exclusive
+  uint64_t d_waitHist[LOCK_PROFILE_BUCKETS];
+  uint64_t d_holdHist[LOCK_PROFILE_BUCKETS];
+  Site d_sites[LOCK_PROFILE_SITES];
+  uint64_t d_otherSites;
+};
+
+
+//==============================================================================
+// LockProfileXp::of()
+//==============================================================================
+LockProfileXp *LockProfileXp::of(const void *lock, const char *kind)
+{
+ LockProfileXp *t = table();
+ LockProfileXp *p, *free = NULL;
+ const void *key;
+ uint32_t h = hash(lock);
+
+ // Lock free lookup, entries are only added under the registry lock
+ for(uint32_t i = 0; i < LOCK_PROFILE_LOCKS; i++)
+ {
+  key = __atomic_load_n(&t[(h + i) & (LOCK_PROFILE_LOCKS - 1)].d_lock, __ATOMIC_ACQUIRE);
+  if(key == lock)
+   return &t[(h + i) & (LOCK_PROFILE_LOCKS - 1)];
+  if(key == NULL)
+   break;
+ }
+
+ pthread_mutex_lock(registryLock());
+ for(uint32_t i = 0; i < LOCK_PROFILE_LOCKS; i++)
+ {
+  p = &t[(h + i) & (LOCK_PROFILE_LOCKS - 1)];
+  if(p->d_lock == lock)
+  {
+   pthread_mutex_unlock(registryLock());
+   return p;
+  }
+  if(!isLive(p->d_lock) && free == NULL)
+   free = p;
+  if(p->d_lock == NULL)
+   break;
+ }
+ if(free != NULL)
+ {
+  free->reset();
+  free->d_kind = kind;
+  free->d_name = NULL;
+  __atomic_store_n(&free->d_lock, lock, __ATOMIC_RELEASE);
+ }
+ else
+  free = &t[LOCK_PROFILE_LOCKS];
+ pthread_mutex_unlock(registryLock());
+ return free;
+}
+
+
+//==============================================================================
+// LockProfileXp::forget()
+//==============================================================================
+void LockProfileXp::forget(const void *lock)
+{
+ LockProfileXp *t = table();
+ LockProfileXp *p;
+ uint32_t h = hash(lock);
+
+ pthread_mutex_lock(registryLock());
+ for(uint32_t i = 0; i < LOCK_PROFILE_LOCKS; i++)
+ {
+  p = &t[(h + i) & (LOCK_PROFILE_LOCKS - 1)];
+  if(p->d_lock == NULL)
+   break;
+  if(p->d_lock == lock)
+  {
+   // Keeps the probe chains of other locks intact
+   __atomic_store_n(&p->d_lock, (const void *)&t[LOCK_PROFILE_LOCKS], __ATOMIC_RELEASE);
+   break;
+  }
+ }
+ pthread_mutex_unlock(registryLock());
+}
+
+
+//==============================================================================
+// LockProfileXp::setName()
+//==============================================================================
+void LockProfileXp::setName(const char *name)
+{
+ d_name = name;
+}
+
+
+//==============================================================================
+// LockProfileXp::now()
+//==============================================================================
+uint64_t LockProfileXp::now()
+{
+ struct timespec ts;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+//==============================================================================
+// LockProfileXp::acquired()
+//==============================================================================
+void LockProfileXp::acquired(uint64_t waitStart, bool contended, void *site, bool exclusive)
+{
+ uint64_t t = now();
+
+ __atomic_add_fetch(&d_acquisitions, 1, __ATOMIC_RELAXED);
+ d_exclusive = exclusive;
+ if(exclusive)
+  d_holdStart = t;
+ if(!contended)
+  return;
+
+ __atomic_add_fetch(&d_contended, 1, __ATOMIC_RELAXED);
+ __atomic_add_fetch(&d_waitHist[bucket(t - waitStart)], 1, __ATOMIC_RELAXED);
+
+ if(site == NULL)
+  return;
+ for(int i = 0; i < LOCK_PROFILE_SITES; i++)
+ {
+  void *expected = NULL;
+  if(__atomic_load_n(&d_sites[i].address, __ATOMIC_ACQUIRE) == site ||
+     __atomic_compare_exchange_n(&d_sites[i].address, &expected, site, false,
+                                 __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ||
+     expected == site)
+  {
+   __atomic_add_fetch(&d_sites[i].count, 1, __ATOMIC_RELAXED);
+   return;
+  }
+ }
+ __atomic_add_fetch(&d_otherSites, 1, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// LockProfileXp::released()
+//==============================================================================
+void LockProfileXp::released()
+{
+ // Shared holders can not run while the exclusive one holds the lock
+ if(!d_exclusive)
+  return;
+ d_exclusive = false;
+ __atomic_add_fetch(&d_holdHist[bucket(now() - d_holdStart)], 1, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// LockProfileXp::reset()
+//==============================================================================
+void LockProfileXp::reset()
+{
+ d_acquisitions = 0;
+ d_contended = 0;
+ d_holdStart = 0;
+ d_exclusive = false;
+ d_otherSites = 0;
+ for(int i = 0; i < LOCK_PROFILE_BUCKETS; i++)
+ {
+  d_waitHist[i] = 0;
+  d_holdHist[i] = 0;
+ }
+ for(int i = 0; i < LOCK_PROFILE_SITES; i++)
+ {
+  d_sites[i].address = NULL;
+  d_sites[i].count = 0;
+ }
+}
+
+
+//==============================================================================
+// LockProfileXp::dump()
+//==============================================================================
+void LockProfileXp::dump(std::ostream &out) const
+{
+ Site sites[LOCK_PROFILE_SITES];
+ Site tmp;
+
+ if(this == &table()[LOCK_PROFILE_LOCKS])
+  out << "locks beyond LOCK_PROFILE_LOCKS";
+ else
+ {
+  out << d_kind << " ";
+  if(d_name != NULL)
+   out << d_name;
+  else
+   out << d_lock;
+ }
+ out << ": acquisitions " << d_acquisitions
+     << ", contended " << d_contended << "\n";
+
+ dumpHistogram(out, "wait", d_waitHist);
+ dumpHistogram(out, "hold", d_holdHist);
+
+ // Most contended sites first
+ for(int i = 0; i < LOCK_PROFILE_SITES; i++)
+  sites[i] = d_sites[i];
+ for(int i = 0; i < LOCK_PROFILE_SITES; i++)
+  for(int j = i + 1; j < LOCK_PROFILE_SITES; j++)
+   if(sites[j].count > sites[i].count)
+   {
+    tmp = sites[i];
+    sites[i] = sites[j];
+    sites[j] = tmp;
+   }
+ for(int i = 0; i < LOCK_PROFILE_SITES && sites[i].address != NULL; i++)
+  out << "  site " << sites[i].address << ": " << sites[i].count << "\n";
+ if(d_otherSites != 0)
+  out << "  other sites: " << d_otherSites << "\n";
+}
+
+
+//==============================================================================
+// LockProfileXp::dumpAll()
+//==============================================================================
+void LockProfileXp::dumpAll(std::ostream &out)
+{
+ LockProfileXp *t = table();
+
+ pthread_mutex_lock(registryLock());
+ for(int i = 0; i < LOCK_PROFILE_LOCKS; i++)
+  if(isLive(t[i].d_lock))
+   t[i].dump(out);
+ if(t[LOCK_PROFILE_LOCKS].d_acquisitions != 0)
+  t[LOCK_PROFILE_LOCKS].dump(out);
+ pthread_mutex_unlock(registryLock());
+ out.flush();
+}
+
+
+//==============================================================================
+// LockProfileXp::resetAll()
+//==============================================================================
+void LockProfileXp::resetAll()
+{
+ LockProfileXp *t = table();
+
+ pthread_mutex_lock(registryLock());
+ for(int i = 0; i <= LOCK_PROFILE_LOCKS; i++)
+  t[i].reset();
+ pthread_mutex_unlock(registryLock());
+}
+
+
+//==============================================================================
+// LockProfileXp::registryLock()
+//==============================================================================
+pthread_mutex_t *LockProfileXp::registryLock()
+{
+ static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+ return &lock;
+}
+
+
+//==============================================================================
+// LockProfileXp::table()
+//==============================================================================
+LockProfileXp *LockProfileXp::table()
+{
+ // Zero filled static storage: every key NULL
+ static LockProfileXp entries[LOCK_PROFILE_LOCKS + 1];
+ return entries;
+}
+
+
+//==============================================================================
+// LockProfileXp::hash()
+//==============================================================================
+uint32_t LockProfileXp::hash(const void *lock)
+{
+ uint64_t x = (uintptr_t)lock;
+
+ // MurmurHash3 finalizer, locks are often a fixed stride apart
+ x ^= x >> 33;
+ x *= 0xff51afd7ed558ccdULL;
+ x ^= x >> 33;
+ return (uint32_t)x;
+}
+
+
+//==============================================================================
+// LockProfileXp::isLive()
+//==============================================================================
+bool LockProfileXp::isLive(const void *key)
+{
+ // The address of the overflow entry marks a forgotten lock
+ return key != NULL && key != (const void *)&table()[LOCK_PROFILE_LOCKS];
+}
+
+
+//==============================================================================
+// LockProfileXp::bucket()
+//==============================================================================
+int LockProfileXp::bucket(uint64_t ns)
+{
+ int b = 0;
+ while(ns > 1 && b < LOCK_PROFILE_BUCKETS - 1)
+ {
+  ns >>= 1;
+  b++;
+ }
+ return b;
+}
+
+
+//==============================================================================
+// LockProfileXp::dumpHistogram()
+//==============================================================================
+void LockProfileXp::dumpHistogram(std::ostream &out, const char *title, const uint64_t *hist)
+{
+ for(int i = 0; i < LOCK_PROFILE_BUCKETS; i++)
+ {
+  if(hist[i] == 0)
+   continue;
+  out << "  " << title << " < " << std::setw(12) << (1ULL << (i + 1))
+      << " ns: " << hist[i] << "\n";
+ }
+}
+
+#else // ZNM_LOCK_PROFILE
+
+#define LOCK_PROFILE_NOINLINE
+
+#endif // ZNM_LOCK_PROFILE
+
+#endif // _LOCKPROFILEXP_HPP_INCLUDED
@@ -12,6 +12,13 @@
 #include <pthread.h>
 #include <time.h>
 #include "znmException.hpp"
+#include "LockProfileXp.hpp"
+#include "DeadlineXp.hpp"
+
+#if defined(__GLIBC__) && defined(__USE_GNU) && !defined(__XENO__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define MUTEX_HAVE_CLOCKLOCK 1 // pthread_mutex_clocklock() is available
+#endif
 
 //==============================================================================
 // class MutexXp
@@ -26,6 +33,13 @@
 //     the same mutex again.
 // <li>This class will throw an exception of type ZnmException in case of
 //     errors.
+// <li>A mutex constructed with PTHREAD_MUTEX_ROBUST survives the death of
+//     its owner: the next locker gets the mutex back, the recovery hook
+//     (see setRecoveryHook()) is called to repair the protected state and
+//     the mutex is marked consistent again. This is meant for mutexes
+//     shared between processes.
+// <li>Built with -DZNM_LOCK_PROFILE, every MutexXp records contention
+//     statistics (see LockProfileXp.hpp).
 // </ul>
 //
 // <b>Example Program:</b>
@@ -33,49 +47,106 @@
 // MutexXp.t.cpp
 //==============================================================================
 
+typedef bool (*MutexRecoveryHook)(void *arg);
+ // Called with the mutex held after its previous owner died.
+ // Return true if the protected data is consistent again, false
+ // to leave the mutex permanently unusable (ENOTRECOVERABLE).
+
 class MutexXp
 {
  friend class CondVariableXp;
  public:
   inline MutexXp(int type =  PTHREAD_MUTEX_DEFAULT,
                 int proto = PTHREAD_PRIO_NONE,
-                int pshared = PTHREAD_PROCESS_PRIVATE);
+                int pshared = PTHREAD_PROCESS_PRIVATE,
+                int robust = PTHREAD_MUTEX_STALLED);
    // Constructs a MutexXp
  
   inline ~MutexXp();
    // Deletes a MutexXp
 
-  inline void lock();
+  inline LOCK_PROFILE_NOINLINE void lock();
    // Locks a mutex. If the mutex is locked by another thread, 
    // this thread is blocked until the mutex gets unlocked.
 
   inline void unlock();
    // Unlocks a mutex.
 
-  inline int tryLock();
+  inline LOCK_PROFILE_NOINLINE int tryLock();
    // Returns 0 and locks the mutex if it is not already locked by another 
    // thread, else returns -1.
 
-  inline int timedLock(const struct timespec *to);
+  inline LOCK_PROFILE_NOINLINE int timedLock(const struct timespec *to);
+
+  inline LOCK_PROFILE_NOINLINE int timedLock(const DeadlineXp &deadline);
+   // Like timedLock() with an absolute CLOCK_REALTIME time, but takes a
+   // CLOCK_MONOTONIC deadline or a TimeoutXp. Returns 0 if the mutex
+   // was locked, -1 on timeout.
+
+  inline void setRecoveryHook(MutexRecoveryHook hook, void *arg = NULL);
+   // Sets the function called when a robust mutex is acquired after
+   // its owner died. The hook is kept per process, so every process
+   // using a mutex in shared memory sets its own. Without a hook the
+   // mutex is simply marked consistent again. NULL removes the hook,
+   // as the destructor does.
+
+  inline unsigned int getRecoveryCount() const;
+   // Returns how many times the mutex was recovered.
+
+  inline void setProfileName(const char *name);
+   // Labels this mutex in LockProfileXp::dumpAll(). Does nothing
+   // unless built with ZNM_LOCK_PROFILE.
 
   //======== END OF INTERFACE ========
 
  private:
+  struct RecoveryEntry
+  {
+   const pthread_mutex_t *mutex;
+   MutexRecoveryHook hook;
+   void *arg;
+  };
+
+  static inline RecoveryEntry *recoveryTable(pthread_mutex_t **lock);
+   // Process local table of hooks. A hook can not be stored in the
+   // object itself since the object may live in shared memory.
+
+  inline void recover(const char *fname);
+   // Handles EOWNERDEAD, the mutex is held by the caller.
+
+  inline int checkLock(int errNumber, const char *fname);
+   // Turns EOWNERDEAD into a recovery, returns other codes.
+
+  inline int lockUntil(const struct timespec *to, clockid_t clk_id, void *caller);
+   // Common part of the timedLock() variants.
+
+  inline int pthreadTimedLock(const struct timespec *to, clockid_t clk_id,
+                              const char **fname);
+   // pthread_mutex_clocklock() or, for CLOCK_REALTIME,
+   // pthread_mutex_timedlock(). Sets *fname to the function called.
   
   pthread_mutex_t d_mutex;
    // The mutex object
+
+  unsigned int d_recoveries;
+   // Number of recoveries done through this object
 };
 
+#define MUTEX_RECOVERY_HOOKS 64 // Maximum number of mutexes with a hook
+
 
 //==============================================================================
 // MutexXp::MutexXp()
 //==============================================================================
 MutexXp::MutexXp(int type /*=  PTHREAD_MUTEX_DEFAULT*/,
                 int proto /*= PTHREAD_PRIO_NONE*/,
-                int pshared /*= PTHREAD_PROCESS_PRIVATE*/
+                int pshared /*= PTHREAD_PROCESS_PRIVATE*/,
+                int robust /*= PTHREAD_MUTEX_STALLED*/
                 )
 {
  pthread_mutexattr_t mAttr;
+
+ d_recoveries = 0;
   
  ERROR_CHECK_RET( pthread_mutexattr_init(&mAttr) , "MutexXp", "pthread_mutexattr_init"); 
  
@@ -83,6 +154,7 @@ MutexXp::MutexXp(int type /*=  PTHREAD_MUTEX_DEFAULT*/,
  ERROR_CHECK_RET( pthread_mutexattr_settype (&mAttr, type) , "MutexXp", "pthread_mutexattr_settype");
  ERROR_CHECK_RET( pthread_mutexattr_setprotocol(&mAttr, proto) , "MutexXp", "pthread_mutexattr_setprotocol");
  ERROR_CHECK_RET( pthread_mutexattr_setpshared(&mAttr, pshared) , "MutexXp", "pthread_mutexattr_setpshared");
+ ERROR_CHECK_RET( pthread_mutexattr_setrobust(&mAttr, robust) , "MutexXp", "pthread_mutexattr_setrobust");
 
  ERROR_CHECK_RET( pthread_mutex_init(&d_mutex, &mAttr) , "MutexXp", "pthread_mutex_init"); // init mutex
 
@@ -95,6 +167,11 @@ MutexXp::MutexXp(int type /*=  PTHREAD_MUTEX_DEFAULT*/,
 //==============================================================================
 MutexXp::~MutexXp()
 {
+ // A later mutex at this address must not inherit the hook
+ setRecoveryHook(NULL);
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::forget(this);
+#endif
  ERROR_CHECK_RET( pthread_mutex_destroy(&d_mutex), "MutexXp", "pthread_mutex_destroy");
 }
 
@@ -104,7 +181,22 @@ MutexXp::~MutexXp()
 //==============================================================================
 void MutexXp::lock()
 {
- ERROR_CHECK_RET( pthread_mutex_lock(&d_mutex) , "MutexXp", "pthread_mutex_lock");
+#ifdef ZNM_LOCK_PROFILE
+ uint64_t start = 0;
+ int errNumber;
+
+ // Contended if the first try fails
+ errNumber = checkLock(pthread_mutex_trylock(&d_mutex), "pthread_mutex_trylock");
+ if(errNumber == EBUSY)
+ {
+  start = LockProfileXp::now();
+  errNumber = checkLock(pthread_mutex_lock(&d_mutex), "pthread_mutex_lock");
+ }
+ ERROR_CHECK_RET( errNumber , "MutexXp", "pthread_mutex_lock");
+ LockProfileXp::of(this, "MutexXp")->acquired(start, start != 0, __builtin_return_address(0), true);
+#else
+ ERROR_CHECK_RET( checkLock(pthread_mutex_lock(&d_mutex), "pthread_mutex_lock") , "MutexXp", "pthread_mutex_lock");
+#endif
 }
 
 
@@ -113,6 +205,9 @@ void MutexXp::lock()
 //==============================================================================
 void MutexXp::unlock()
 {
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::of(this, "MutexXp")->released();
+#endif
  ERROR_CHECK_RET( pthread_mutex_unlock(&d_mutex) , "MutexXp", "pthread_mutex_unlock");
 }
 
@@ -124,9 +219,14 @@ int MutexXp::tryLock()
 {
  int errNumber;
 
- errNumber = pthread_mutex_trylock(&d_mutex);
+ errNumber = checkLock(pthread_mutex_trylock(&d_mutex), "pthread_mutex_trylock");
  if (errNumber == 0)
+ {
+#ifdef ZNM_LOCK_PROFILE
+  LockProfileXp::of(this, "MutexXp")->acquired(0, false, __builtin_return_address(0), true);
+#endif
   return 0;
+ }
  else if(errNumber == EBUSY)
   return -1;
  throw(ZnmException("MutexXp", "pthread_mutex_trylock", errNumber));
@@ -138,18 +238,192 @@ int MutexXp::tryLock()
 // MutexXp::timedLock(const struct timespec *to)
 //==============================================================================
 int MutexXp::timedLock(const struct timespec *to)
+{
+ return lockUntil(to, CLOCK_REALTIME, __builtin_return_address(0));
+}
+
+
+//==============================================================================
+// MutexXp::timedLock(const DeadlineXp &deadline)
+//==============================================================================
+int MutexXp::timedLock(const DeadlineXp &deadline)
+{
+ struct timespec to;
+
+#ifdef MUTEX_HAVE_CLOCKLOCK
+ deadline.toTimespec(CLOCK_MONOTONIC, &to);
+ return lockUntil(&to, CLOCK_MONOTONIC, __builtin_return_address(0));
+#else
+ deadline.toTimespec(CLOCK_REALTIME, &to);
+ return lockUntil(&to, CLOCK_REALTIME, __builtin_return_address(0));
+#endif
+}
+
+
+//==============================================================================
+// MutexXp::setRecoveryHook(MutexRecoveryHook hook, void *arg)
+//==============================================================================
+void MutexXp::setRecoveryHook(MutexRecoveryHook hook, void *arg)
+{
+ pthread_mutex_t *tableLock;
+ RecoveryEntry *table = recoveryTable(&tableLock);
+ RecoveryEntry *slot = NULL;
+
+ ERROR_CHECK_RET( pthread_mutex_lock(tableLock) , "MutexXp", "pthread_mutex_lock");
+ for(int i = 0; i < MUTEX_RECOVERY_HOOKS; i++)
+ {
+  if(table[i].mutex == &d_mutex)
+  {
+   slot = &table[i];
+   break;
+  }
+  if(slot == NULL && table[i].mutex == NULL)
+   slot = &table[i];
+ }
+ if(slot != NULL)
+ {
+  slot->mutex = (hook != NULL) ? &d_mutex : NULL;
+  slot->hook = hook;
+  slot->arg = arg;
+ }
+ pthread_mutex_unlock(tableLock);
+
+ // Removing a hook that was never set needs no free entry
+ if(slot == NULL && hook != NULL)
+  throw(ZnmException("MutexXp", "setRecoveryHook", ENOSPC));
+}
+
+
+//==============================================================================
+// MutexXp::getRecoveryCount()
+//==============================================================================
+unsigned int MutexXp::getRecoveryCount() const
+{
+ return d_recoveries;
+}
+
+
+//==============================================================================
+// MutexXp::setProfileName(const char *name)
+//==============================================================================
+void MutexXp::setProfileName(const char *name)
+{
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::of(this, "MutexXp")->setName(name);
+#else
+ (void)name;
+#endif
+}
+
+
+//==============================================================================
+// MutexXp::recoveryTable(pthread_mutex_t **lock)
+//==============================================================================
+MutexXp::RecoveryEntry *MutexXp::recoveryTable(pthread_mutex_t **lock)
+{
+ static RecoveryEntry table[MUTEX_RECOVERY_HOOKS];
+ static pthread_mutex_t tableLock = PTHREAD_MUTEX_INITIALIZER;
+
+ *lock = &tableLock;
+ return table;
+}
+
+
+//==============================================================================
+// MutexXp::recover(const char *fname)
+//==============================================================================
+void MutexXp::recover(const char *fname)
+{
+ pthread_mutex_t *tableLock;
+ RecoveryEntry *table = recoveryTable(&tableLock);
+ MutexRecoveryHook hook = NULL;
+ void *arg = NULL;
+
+ ERROR_CHECK_RET( pthread_mutex_lock(tableLock) , "MutexXp", "pthread_mutex_lock");
+ for(int i = 0; i < MUTEX_RECOVERY_HOOKS; i++)
+ {
+  if(table[i].mutex == &d_mutex)
+  {
+   hook = table[i].hook;
+   arg = table[i].arg;
+   break;
+  }
+ }
+ pthread_mutex_unlock(tableLock);
+
+ // Unlocking without marking consistent makes the mutex unusable
+ if(hook != NULL && !hook(arg))
+ {
+  pthread_mutex_unlock(&d_mutex);
+  throw(ZnmException("MutexXp", fname, ENOTRECOVERABLE));
+ }
+
+ ERROR_CHECK_RET( pthread_mutex_consistent(&d_mutex) , "MutexXp", "pthread_mutex_consistent");
+ __atomic_add_fetch(&d_recoveries, 1, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// MutexXp::checkLock(int errNumber, const char *fname)
+//==============================================================================
+int MutexXp::checkLock(int errNumber, const char *fname)
+{
+ if(errNumber != EOWNERDEAD)
+  return errNumber;
+ recover(fname);
+ return 0;
+}
+
+
+//==============================================================================
+// MutexXp::lockUntil(const struct timespec *to, clockid_t clk_id, void *caller)
+//==============================================================================
+int MutexXp::lockUntil(const struct timespec *to, clockid_t clk_id, void *caller)
 {
  int errNumber;
+ const char *fname = "pthread_mutex_timedlock";
+
+#ifdef ZNM_LOCK_PROFILE
+ uint64_t start = 0;
 
- errNumber = pthread_mutex_timedlock (&d_mutex, to);
+ errNumber = checkLock(pthread_mutex_trylock(&d_mutex), "pthread_mutex_trylock");
+ if(errNumber == EBUSY)
+ {
+  start = LockProfileXp::now();
+  errNumber = checkLock(pthreadTimedLock(to, clk_id, &fname), fname);
+ }
+ if (errNumber == 0)
+  LockProfileXp::of(this, "MutexXp")->acquired(start, start != 0, caller, true);
+#else
+ (void)caller;
+ errNumber = checkLock(pthreadTimedLock(to, clk_id, &fname), fname);
+#endif
  
  if (errNumber == 0)
   return 0;
  else if(errNumber == ETIMEDOUT)
   return -1;
- throw(ZnmException( "MutexXp", "pthread_mutex_timedlock", errNumber));
+ throw(ZnmException( "MutexXp", fname, errNumber));
 }
 
 
+//==============================================================================
+// MutexXp::pthreadTimedLock(const struct timespec *to, clockid_t clk_id,
+//                           const char **fname)
+//==============================================================================
+int MutexXp::pthreadTimedLock(const struct timespec *to, clockid_t clk_id,
+                              const char **fname)
+{
+#ifdef MUTEX_HAVE_CLOCKLOCK
+ if(clk_id != CLOCK_REALTIME)
+ {
+  *fname = "pthread_mutex_clocklock";
+  return pthread_mutex_clocklock(&d_mutex, clk_id, to);
+ }
+#endif
+ *fname = "pthread_mutex_timedlock";
+ return pthread_mutex_timedlock(&d_mutex, to);
+}
+
 
 #endif // MUTEXXP_HPP_INCLUDED
@@ -0,0 +1,246 @@
+//==============================================================================
+// PeriodicThreadXp.cpp - Thread released at a fixed period.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "PeriodicThreadXp.hpp"
+#include "ShMemStatsXp.hpp"
+#include "znmException.hpp"
+#include <time.h>
+#include <string.h>
+
+//==============================================================================
+// PeriodicThreadXp::PeriodicThreadXp
+//==============================================================================
+PeriodicThreadXp::PeriodicThreadXp(const TimeoutXp &period,
+                                   int policy /*= SCHED_OTHER*/,
+                                   int sched_priority /*= 0*/,
+                                   const char *name /*= NULL*/,
+                                   const cpu_set_t *cpuMask /*= NULL*/,
+                                   size_t stacksize /*= PTHREAD_STACK_MIN*/)
+ : ThreadXp(PTHREAD_CREATE_JOINABLE, stacksize, PTHREAD_EXPLICIT_SCHED,
+            policy, sched_priority, name, 1, cpuMask)
+{
+ if(period.getNanoseconds() <= 0)
+  throw ZnmException("PeriodicThreadXp", "period", EINVAL);
+
+ d_period = period.getNanoseconds();
+ d_reset = 0;
+ d_seq = 0;
+ memset(&d_stats, 0, sizeof(d_stats));
+ d_sampleEvery = 0;
+ d_statsPage = NULL;
+ d_statsSlot = -1;
+ d_watchdog = NULL;
+ d_watchdogPeriods = 2;
+ d_watchdogActions = WATCHDOG_REPORT;
+ d_watchdogId = -1;
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::stop
+//==============================================================================
+void PeriodicThreadXp::stop()
+{
+ requestStop();
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::getStats
+//==============================================================================
+void PeriodicThreadXp::getStats(PeriodicStatsXp *stats)
+{
+ uint32_t seq;
+
+ do
+ {
+  while((seq = __atomic_load_n(&d_seq, __ATOMIC_ACQUIRE)) & 1)
+   sched_yield();
+  memcpy(stats, &d_stats, sizeof(*stats));
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+ } while(__atomic_load_n(&d_seq, __ATOMIC_RELAXED) != seq);
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::resetStats
+//==============================================================================
+void PeriodicThreadXp::resetStats()
+{
+ __atomic_store_n(&d_reset, 1, __ATOMIC_RELEASE);
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::getPeriod
+//==============================================================================
+TimeoutXp PeriodicThreadXp::getPeriod() const
+{
+ return TimeoutXp(d_period);
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::setUsageSampling
+//==============================================================================
+void PeriodicThreadXp::setUsageSampling(uint32_t cycles,
+                                        ShMemStatsXp *page /*= NULL*/)
+{
+ d_sampleEvery = cycles;
+ d_statsPage = page;
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::setWatchdog
+//==============================================================================
+void PeriodicThreadXp::setWatchdog(WatchdogXp *watchdog, int periods /*= 2*/,
+                                   int actions /*= WATCHDOG_REPORT*/)
+{
+ if(periods <= 0)
+  throw ZnmException("PeriodicThreadXp", "setWatchdog", EINVAL);
+
+ d_watchdog = watchdog;
+ d_watchdogPeriods = periods;
+ d_watchdogActions = actions;
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::overrun
+//==============================================================================
+void PeriodicThreadXp::overrun(uint64_t /*missed*/)
+{
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::enterThread
+//==============================================================================
+void PeriodicThreadXp::enterThread(void * /*arg*/)
+{
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::exitThread
+//==============================================================================
+void PeriodicThreadXp::exitThread(void * /*arg*/)
+{
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::executeInThread
+//==============================================================================
+int PeriodicThreadXp::executeInThread(void *arg)
+{
+ struct timespec ts;
+ int64_t release, next, wake, end;
+ uint64_t missed;
+ uint32_t sinceSample = 0;
+ ThreadUsageXp usage;
+ int code = 0;
+
+ // clock_nanosleep() is a cancellation point and executeCycle() may
+ // throw; without the handler the watchdog would fire for a thread
+ // that is gone
+ pthread_cleanup_push(&(PeriodicThreadXp::detachAll), this);
+ if(d_sampleEvery != 0 && d_statsPage != NULL)
+  d_statsSlot = d_statsPage->attach(getName());
+ if(d_watchdog != NULL)
+  d_watchdogId = d_watchdog->add(getName(), TimeoutXp(d_period * d_watchdogPeriods),
+                                 d_watchdogActions);
+
+ release = DeadlineXp::now().getNanoseconds();
+
+ while(!stopRequested())
+ {
+  ts.tv_sec = release / DEADLINE_NSEC_PER_SEC;
+  ts.tv_nsec = release % DEADLINE_NSEC_PER_SEC;
+  while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+   ;
+
+  wake = DeadlineXp::now().getNanoseconds();
+  code = executeCycle(arg);
+  end = DeadlineXp::now().getNanoseconds();
+
+  next = release + d_period;
+  missed = 0;
+  if(end > next)
+  {
+   // Skip the releases that already passed
+   missed = (end - next) / d_period + 1;
+   next += missed * d_period;
+  }
+
+  record(wake - release, end - wake, missed);
+  if(d_watchdogId >= 0)
+   d_watchdog->kick(d_watchdogId);
+  if(missed != 0)
+   overrun(missed);
+
+  // Outside the measured time, so it does not count as execution
+  if(d_sampleEvery != 0 && ++sinceSample >= d_sampleEvery)
+  {
+   sinceSample = 0;
+   if(sampleUsage(&usage) == 0 && d_statsSlot >= 0)
+    d_statsPage->publish(d_statsSlot, &usage);
+  }
+
+  if(code != 0)
+   break;
+  release = next;
+ }
+ pthread_cleanup_pop(1);
+ return code;
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::detachAll
+//==============================================================================
+void PeriodicThreadXp::detachAll(void *classPtr)
+{
+ PeriodicThreadXp *tPtr = (PeriodicThreadXp *)classPtr;
+
+ if(tPtr->d_statsSlot >= 0)
+  tPtr->d_statsPage->detach(tPtr->d_statsSlot);
+ tPtr->d_statsSlot = -1;
+ if(tPtr->d_watchdogId >= 0)
+  tPtr->d_watchdog->remove(tPtr->d_watchdogId);
+ tPtr->d_watchdogId = -1;
+}
+
+
+//==============================================================================
+// PeriodicThreadXp::record
+//==============================================================================
+void PeriodicThreadXp::record(int64_t jitter, int64_t exec, uint64_t missed)
+{
+ __atomic_store_n(&d_seq, d_seq + 1, __ATOMIC_RELAXED);
+ __atomic_thread_fence(__ATOMIC_RELEASE);
+
+ if(__atomic_exchange_n(&d_reset, 0, __ATOMIC_ACQUIRE))
+  memset(&d_stats, 0, sizeof(d_stats));
+
+ if(d_stats.cycles == 0 || jitter < d_stats.jitterMin)
+  d_stats.jitterMin = jitter;
+ if(d_stats.cycles == 0 || jitter > d_stats.jitterMax)
+  d_stats.jitterMax = jitter;
+ if(d_stats.cycles == 0 || exec < d_stats.execMin)
+  d_stats.execMin = exec;
+ if(d_stats.cycles == 0 || exec > d_stats.execMax)
+  d_stats.execMax = exec;
+ d_stats.jitterSum += jitter;
+ d_stats.execSum += exec;
+ d_stats.overruns += missed;
+ d_stats.cycles++;
+
+ __atomic_store_n(&d_seq, d_seq + 1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,170 @@
+//==============================================================================
+// PeriodicThreadXp.hpp - Thread released at a fixed period.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _PERIODICTHREADXP_HPP_INCLUDED
+#define _PERIODICTHREADXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+#include "ThreadXp.hpp"
+#include "DeadlineXp.hpp"
+#include "WatchdogXp.hpp"
+
+class ShMemStatsXp;
+
+//==============================================================================
+// struct PeriodicStatsXp
+//------------------------------------------------------------------------------
+// \brief
+// Statistics of a PeriodicThreadXp, times in nanoseconds.
+//
+// Release jitter is how late the thread woke up after its release time;
+// execution time is how long executeCycle() ran.
+//==============================================================================
+
+struct PeriodicStatsXp
+{
+ uint64_t cycles;
+  // Cycles executed
+ uint64_t overruns;
+  // Releases missed because a cycle ran past the next release
+ int64_t jitterMin;
+ int64_t jitterMax;
+ int64_t jitterSum;
+ int64_t execMin;
+ int64_t execMax;
+ int64_t execSum;
+};
+
+
+//==============================================================================
+// class PeriodicThreadXp
+//------------------------------------------------------------------------------
+// \brief
+// A ThreadXp that calls executeCycle() once per period.
+//
+// <ul>
+// <li>Release times are absolute (clock_nanosleep() with TIMER_ABSTIME on
+//     CLOCK_MONOTONIC): release n is at start + n * period, however long
+//     the cycles take, so the period does not drift.
+// <li>A cycle that runs past the next release is an overrun. The missed
+//     releases are counted and skipped (not run late in a burst), and
+//     overrun() is called.
+// <li>Release jitter and execution time are recorded every cycle, see
+//     getStats(). CPU time, context switches and faults can be sampled
+//     every n cycles and published to shared memory, see
+//     setUsageSampling().
+// <li>Derived classes override executeCycle() instead of
+//     executeInThread(); enterThread() and exitThread() may be
+//     overridden as for ThreadXp.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  class Control : public PeriodicThreadXp
+//  {
+//   public:
+//    Control() : PeriodicThreadXp(TimeoutXp::milliseconds(1), SCHED_FIFO, 80) {}
+//   protected:
+//    virtual int executeCycle(void *arg) { ...; return 0; }
+//  };
+// </pre>
+//==============================================================================
+
+class PeriodicThreadXp : public ThreadXp
+{
+ public:
+  PeriodicThreadXp(const TimeoutXp &period,
+                   int policy = SCHED_OTHER,
+                   int sched_priority = 0,
+                   const char *name = NULL,
+                   const cpu_set_t *cpuMask = NULL,
+                   size_t stacksize = PTHREAD_STACK_MIN);
+   // Constructs a periodic thread; run() starts it. The first
+   // release is right after enterThread().
+   //  period  Must be greater than 0.
+
+  void stop();
+   // Makes the thread return after the current cycle, same as
+   // requestStop().
+
+  void getStats(PeriodicStatsXp *stats);
+   // Copies a consistent snapshot of the statistics. Can be called
+   // from any thread.
+
+  void resetStats();
+   // Clears the statistics from the next cycle on.
+
+  TimeoutXp getPeriod() const;
+
+  void setUsageSampling(uint32_t cycles, ShMemStatsXp *page = NULL);
+   // Calls sampleUsage() every 'cycles' cycles, after the cycle, and
+   // publishes the sample to 'page' if it is not NULL. Call before
+   // run(); 0 turns sampling off.
+
+  void setWatchdog(WatchdogXp *watchdog, int periods = 2,
+                   int actions = WATCHDOG_REPORT);
+   // Registers the thread with 'watchdog' while it runs and kicks it
+   // after every cycle, so a cycle that has not ended 'periods' periods
+   // after the last one is reported. Call before run(); NULL turns it
+   // off.
+   //  actions  As for WatchdogXp::add().
+
+ protected:
+  virtual int executeCycle(void *arg) = 0;
+   // The work of one cycle.
+   //  arg     Arguments passed by the call to run().
+   //  return  0 to continue, anything else stops the thread and
+   //          is returned by join().
+
+  virtual void overrun(uint64_t missed);
+   // Called in the thread after a cycle that missed 'missed'
+   // releases. Does nothing by default.
+
+  virtual void enterThread(void *arg);
+
+  virtual int executeInThread(void *arg);
+
+  virtual void exitThread(void *arg);
+
+  //======== END OF INTERFACE ========
+
+ private:
+  void record(int64_t jitter, int64_t exec, uint64_t missed);
+
+  static void detachAll(void *classPtr);
+   // Cleanup handler of executeInThread(): gives back the stats slot
+   // and watchdog entry also on cancel() or an exception.
+
+  int64_t d_period;
+   // ns
+
+  int d_reset;
+   // Set by resetStats(), cleared by the thread
+
+  uint32_t d_seq;
+   // Odd while d_stats is being written
+
+  PeriodicStatsXp d_stats;
+
+  uint32_t d_sampleEvery;
+
+  ShMemStatsXp *d_statsPage;
+
+  int d_statsSlot;
+   // Slot in d_statsPage while running, else -1
+
+  WatchdogXp *d_watchdog;
+  int d_watchdogPeriods;
+  int d_watchdogActions;
+  int d_watchdogId;
+   // Entry in d_watchdog while running, else -1
+};
+
+#endif // _PERIODICTHREADXP_HPP_INCLUDED
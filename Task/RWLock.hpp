@@ -0,0 +1,235 @@
+//==============================================================================
+// RWLock.hpp - Reader/Writer lock wrapper class.
+//
+// Author        : Vilas Kumar Chitrakaran
+// Version       : 2.0 (Apr 2005)
+// Compatibility : POSIX, GCC
+//==============================================================================
+
+#ifndef _RWLOCK_HPP_INCLUDED
+#define _RWLOCK_HPP_INCLUDED
+
+#include <pthread.h>
+#include "ErrnoException.hpp"
+#include "LockProfileXp.hpp"
+
+//==============================================================================
+// class RWLock
+//------------------------------------------------------------------------------
+// \brief
+// The pthread reader-writer lock.
+//
+// <ul>
+// <li>A Reader-Writer lock allows concurrent access to multiple processes for 
+//     reading shared data, but restricts writing to shared data only when 
+//     no readers are present.
+// <li>Conversely, when a writer has access to shared data, 
+//     all other writers and readers are blocked until the writer is done.
+// <li>This class will throw an exception of type ErrnoException in case of
+//     errors.
+// <li>Built with -DZNM_LOCK_PROFILE, every RWLock records contention
+//     statistics (see LockProfileXp.hpp). Hold times are recorded for
+//     write locks only.
+// </ul>
+//
+// <b>Example Program:</b>
+// \include RWLock.t.cpp
+//==============================================================================
+
+class RWLock
+{
+ public:
+  inline RWLock(int pshared = PTHREAD_PROCESS_PRIVATE);
+   // Constructor initializes the lock.
+   //  pshared  PTHREAD_PROCESS_SHARED if the lock lives in
+   //           shared memory and is used by several processes.
+   
+  inline ~RWLock();
+   // Destroys the lock.
+   
+  inline LOCK_PROFILE_NOINLINE void readLock();
+   // Acquire the shared lock for read access. 
+   // If the lock is not available, block until it is.
+   
+  inline LOCK_PROFILE_NOINLINE int tryReadLock();
+   // Try to acquire the shared lock for read access. 
+   // If the lock is not available, return immediately.
+   //  return  0 on successful acquisition of lock, else -1
+
+  inline LOCK_PROFILE_NOINLINE void writeLock();
+   // Acquire the shared lock for exclusive write access. 
+   // If the lock is not available, block until it is.
+
+  inline LOCK_PROFILE_NOINLINE int tryWriteLock();
+   // Try to acquire the shared lock for exclusive write access. 
+   // If the lock is not available, return immediately.
+   //  return  0 on successful acquisition of lock, else -1
+
+  inline void unlock();
+   // Unlock the shared lock. If the calling thread doesn't own
+   // the lock, the behavior of this function is undefined.
+
+  inline void setProfileName(const char *name);
+   // Labels this lock in LockProfileXp::dumpAll(). Does nothing
+   // unless built with ZNM_LOCK_PROFILE.
+   
+  //======== END OF INTERFACE ========
+ private:
+  inline void errorCheck(int code);
+   // This will throw an exception on any error.
+
+  pthread_rwlock_t d_rwl;
+   // The pthread lock
+  
+};
+
+
+//==============================================================================
+// RWLock::RWLock
+//==============================================================================
+RWLock::RWLock(int pshared)
+{
+ pthread_rwlockattr_t attr;
+ errorCheck( pthread_rwlockattr_init(&attr) );
+ errorCheck( pthread_rwlockattr_setpshared(&attr, pshared) );
+ errorCheck( pthread_rwlock_init(&d_rwl, &attr) );
+ pthread_rwlockattr_destroy(&attr);
+}
+
+
+//==============================================================================
+// RWLock::~RWLock
+//==============================================================================
+RWLock::~RWLock()
+{
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::forget(this);
+#endif
+ pthread_rwlock_destroy(&d_rwl);
+}
+
+
+//==============================================================================
+// RWLock::readLock
+//==============================================================================
+void RWLock::readLock()
+{
+#ifdef ZNM_LOCK_PROFILE
+ uint64_t start = 0;
+
+ if(pthread_rwlock_tryrdlock(&d_rwl) != 0)
+ {
+  start = LockProfileXp::now();
+  errorCheck( pthread_rwlock_rdlock(&d_rwl) );
+ }
+ LockProfileXp::of(this, "RWLock")->acquired(start, start != 0, __builtin_return_address(0), false);
+#else
+ errorCheck( pthread_rwlock_rdlock(&d_rwl) );
+#endif
+}
+
+
+//==============================================================================
+// RWLock::tryReadLock
+//==============================================================================
+int RWLock::tryReadLock()
+{
+ int retVal;
+
+ retVal = pthread_rwlock_tryrdlock(&d_rwl);
+
+ if( retVal == 0 )
+ {
+#ifdef ZNM_LOCK_PROFILE
+  LockProfileXp::of(this, "RWLock")->acquired(0, false, __builtin_return_address(0), false);
+#endif
+  return 0;
+ }
+  
+ if( retVal == EAGAIN || retVal == EBUSY ) 
+  return -1;
+ 
+ errorCheck(retVal);
+ return -1;
+}
+
+
+//==============================================================================
+// RWLock::writeLock
+//==============================================================================
+void RWLock::writeLock()
+{
+#ifdef ZNM_LOCK_PROFILE
+ uint64_t start = 0;
+
+ if(pthread_rwlock_trywrlock(&d_rwl) != 0)
+ {
+  start = LockProfileXp::now();
+  errorCheck( pthread_rwlock_wrlock(&d_rwl) );
+ }
+ LockProfileXp::of(this, "RWLock")->acquired(start, start != 0, __builtin_return_address(0), true);
+#else
+ errorCheck( pthread_rwlock_wrlock(&d_rwl) );
+#endif
+}
+
+
+//==============================================================================
+// RWLock::tryWriteLock
+//==============================================================================
+int RWLock::tryWriteLock()
+{
+ int retVal;
+ retVal = pthread_rwlock_trywrlock(&d_rwl);
+ 
+ if( retVal == 0 )
+ {
+#ifdef ZNM_LOCK_PROFILE
+  LockProfileXp::of(this, "RWLock")->acquired(0, false, __builtin_return_address(0), true);
+#endif
+  return 0;
+ }
+ 
+ if( retVal == EAGAIN || retVal == EBUSY ) 
+  return -1;
+ 
+ errorCheck(retVal);
+ return -1;
+}
+
+
+//==============================================================================
+// RWLock::unlock
+//==============================================================================
+void RWLock::unlock()
+{
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::of(this, "RWLock")->released();
+#endif
+ errorCheck( pthread_rwlock_unlock(&d_rwl) );
+}
+
+
+//==============================================================================
+// RWLock::setProfileName
+//==============================================================================
+void RWLock::setProfileName(const char *name)
+{
+#ifdef ZNM_LOCK_PROFILE
+ LockProfileXp::of(this, "RWLock")->setName(name);
+#else
+ (void)name;
+#endif
+}
+
+
+//==============================================================================
+// RWLock::errorCheck
+//==============================================================================
+void RWLock::errorCheck(int code)
+{
+ if(code == 0) return;
+ throw(ErrnoException(code, "[RWLock]"));
+}
+
+#endif // _RWLOCK_HPP_INCLUDED
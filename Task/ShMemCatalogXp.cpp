@@ -0,0 +1,228 @@
+//==============================================================================
+// ShMemCatalogXp.cpp - Named sub-regions inside one shared memory segment.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 restore() with lock re-initialization
+// 19.10.2026   1.2                                 Bounded wait for the initializer
+//==============================================================================
+#include "ShMemCatalogXp.hpp"
+#include <time.h>
+
+static inline uint32_t catalogAlign(uint32_t value){
+	return (value + CATALOG_ALIGNMENT - 1) & ~(uint32_t)(CATALOG_ALIGNMENT - 1);
+}
+
+ShMemCatalogXp::ShMemCatalogXp(const char* name, int size, int maxEntries) :
+			_shm(name, size){
+	_errno = 0;
+	_base = (char*) _shm.getShmAddr();
+	_header = (ShMemCatalogHeader*) _base;
+	_entries = (ShMemCatalogEntry*) (_base + sizeof(ShMemCatalogHeader));
+
+	initialize(maxEntries);
+}
+
+ShMemCatalogXp::~ShMemCatalogXp(){ }
+
+void ShMemCatalogXp::initialize(int maxEntries){
+	uint32_t expected = CATALOG_STATE_EMPTY;
+	uint32_t dataOffset;
+
+	// Whoever wins the race writes the header, creator or not
+	if(__atomic_compare_exchange_n(&_header->state, &expected, CATALOG_STATE_INITIALIZING,
+								false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+
+		dataOffset = catalogAlign(sizeof(ShMemCatalogHeader) +
+								maxEntries * sizeof(ShMemCatalogEntry));
+
+		if(maxEntries <= 0 || dataOffset > (uint32_t)_shm.getShmSize()){
+			__atomic_store_n(&_header->state, CATALOG_STATE_EMPTY, __ATOMIC_RELEASE);
+			_errno = EINVAL;
+			throw ZnmException("Segment too small for catalog", "initialize()", _errno);
+		}
+
+		initLock();
+
+		_header->magic = CATALOG_MAGIC;
+		_header->maxEntries = maxEntries;
+		_header->numEntries = 0;
+		_header->nextOffset = dataOffset;
+		_header->segmentSize = _shm.getShmSize();
+
+		__atomic_store_n(&_header->state, CATALOG_STATE_READY, __ATOMIC_RELEASE);
+	}else{
+		// Someone else is writing the header, wait for it but not
+		// forever: it may have died. Sleeping, not yielding, lets it
+		// run even if it has a lower priority on this CPU.
+		struct timespec pause;
+		pause.tv_sec = 0;
+		pause.tv_nsec = 100000;
+
+		for(int waits = 0; __atomic_load_n(&_header->state, __ATOMIC_ACQUIRE) != CATALOG_STATE_READY; waits++){
+			if(waits == CATALOG_INIT_WAIT_MS * 10){
+				_errno = ETIMEDOUT;
+				throw ZnmException("Catalog initializer does not finish", "initialize()", _errno);
+			}
+			nanosleep(&pause, NULL);
+		}
+	}
+
+	if(_header->magic != CATALOG_MAGIC){
+		_errno = EINVAL;
+		throw ZnmException("Segment is not a catalog", "initialize()", _errno);
+	}
+
+	// Mapping more than the creator truncated would fault on access
+	if((uint32_t)_shm.getShmSize() > _header->segmentSize){
+		_errno = EINVAL;
+		throw ZnmException("Catalog segment is smaller than requested", "initialize()", _errno);
+	}
+
+	_errno = 0;
+}
+
+void ShMemCatalogXp::initLock(){
+	pthread_mutexattr_t attr;
+
+	ERROR_CHECK_RET( pthread_mutexattr_init(&attr), "ShMemCatalogXp", "pthread_mutexattr_init");
+	ERROR_CHECK_RET( pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED), "ShMemCatalogXp", "pthread_mutexattr_setpshared");
+	ERROR_CHECK_RET( pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST), "ShMemCatalogXp", "pthread_mutexattr_setrobust");
+	ERROR_CHECK_RET( pthread_mutex_init(&_header->lock, &attr), "ShMemCatalogXp", "pthread_mutex_init");
+	pthread_mutexattr_destroy(&attr);
+}
+
+int ShMemCatalogXp::restore(const char* path){
+	if(_shm.restore(path) != 0){
+		_errno = _shm.getErrnoError();
+		return -1;
+	}
+
+	if(_header->magic != CATALOG_MAGIC ||
+	   __atomic_load_n(&_header->state, __ATOMIC_ACQUIRE) != CATALOG_STATE_READY){
+		_errno = EINVAL;
+		throw ZnmException("Checkpoint is not a catalog", "restore()", _errno);
+	}
+
+	// The image holds the lock as it was at checkpoint time, possibly
+	// owned by a thread that does not exist any more
+	initLock();
+
+	_errno = 0;
+	return 0;
+}
+
+void* ShMemCatalogXp::find(const char* name, int* size) const{
+	uint32_t count;
+
+	// Entries below numEntries are complete, see create()
+	count = __atomic_load_n(&_header->numEntries, __ATOMIC_ACQUIRE);
+
+	for(uint32_t i = 0; i < count; i++){
+		if(strncmp(_entries[i].name, name, CATALOG_NAME_LEN) == 0){
+			if(size != NULL)
+				*size = _entries[i].size;
+			return _base + _entries[i].offset;
+		}
+	}
+
+	return NULL;
+}
+
+void* ShMemCatalogXp::lookup(const char* name, int* size){
+	_errno = 0;
+	return find(name, size);
+}
+
+void* ShMemCatalogXp::create(const char* name, int size){
+	void* region;
+	int existingSize;
+	uint32_t index;
+	uint32_t offset;
+	int ret;
+
+	if(strlen(name) >= CATALOG_NAME_LEN){
+		_errno = ENAMETOOLONG;
+		throw ZnmException("Region name too long", "create()", _errno);
+	}
+
+	if(size <= 0){
+		_errno = EINVAL;
+		throw ZnmException("Invalid region size", "create()", _errno);
+	}
+
+	// Fast path: region is already there
+	region = find(name, &existingSize);
+
+	if(region == NULL){
+		ret = pthread_mutex_lock(&_header->lock);
+
+		// An entry is visible only after numEntries is stored, so a
+		// creator that died here left nothing half written
+		if(ret == EOWNERDEAD)
+			ret = pthread_mutex_consistent(&_header->lock);
+
+		ERROR_CHECK_RET( ret, "ShMemCatalogXp", "pthread_mutex_lock");
+
+		// Another process may have created it while we were waiting
+		region = find(name, &existingSize);
+
+		if(region == NULL){
+			index = _header->numEntries;
+			offset = _header->nextOffset;
+			ret = 0;
+
+			if(index >= _header->maxEntries)
+				ret = ENOSPC;
+			else if((uint64_t)offset + size > _header->segmentSize)
+				ret = ENOMEM;
+
+			if(ret != 0){
+				pthread_mutex_unlock(&_header->lock);
+				_errno = ret;
+				throw ZnmException("Catalog is full", "create()", _errno);
+			}
+
+			strncpy(_entries[index].name, name, CATALOG_NAME_LEN);
+			_entries[index].offset = offset;
+			_entries[index].size = size;
+			_header->nextOffset = catalogAlign(offset + size);
+
+			// Publish the entry only after it is filled
+			__atomic_store_n(&_header->numEntries, index + 1, __ATOMIC_RELEASE);
+
+			region = _base + offset;
+			existingSize = size;
+		}
+
+		ERROR_CHECK_RET( pthread_mutex_unlock(&_header->lock), "ShMemCatalogXp", "pthread_mutex_unlock");
+	}
+
+	if(existingSize < size){
+		_errno = EEXIST;
+		throw ZnmException("Region exists with a smaller size", "create()", _errno);
+	}
+
+	_errno = 0;
+	return region;
+}
+
+int ShMemCatalogXp::getEntryCount() const{
+	return __atomic_load_n(&_header->numEntries, __ATOMIC_ACQUIRE);
+}
+
+int ShMemCatalogXp::getFreeSize() const{
+	uint32_t next = __atomic_load_n(&_header->nextOffset, __ATOMIC_RELAXED);
+
+	if(next >= _header->segmentSize)
+		return 0;
+
+	return _header->segmentSize - next;
+}
+
+int ShMemCatalogXp::unlink(){
+	return _shm.unlink();
+}
@@ -0,0 +1,130 @@
+//==============================================================================
+// ShMemCatalogXp.hpp - Named sub-regions inside one shared memory segment.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 restore() with lock re-initialization
+// 19.10.2026   1.2                                 Bounded wait for the initializer
+//==============================================================================
+
+#ifndef _SHMEMCATALOG_HPP_INCLUDED
+#define _SHMEMCATALOG_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+#include "ShMemXp.hpp"
+#include "znmException.hpp"
+
+#define CATALOG_MAGIC 0x5A4E4D43      // "ZNMC", marks an initialized catalog
+#define CATALOG_NAME_LEN 32           // Maximum length of a region name (with '\0')
+#define CATALOG_MAX_ENTRIES 32        // Default number of catalog entries
+#define CATALOG_ALIGNMENT 64          // Regions start on a cache line boundary
+#define CATALOG_INIT_WAIT_MS 1000     // Wait for another initializer before ETIMEDOUT
+
+#define CATALOG_STATE_EMPTY 0         // Segment is freshly truncated (zero filled)
+#define CATALOG_STATE_INITIALIZING 1  // One process is writing the header
+#define CATALOG_STATE_READY 2         // Header can be used by everyone
+
+/**
+ * One named region of the segment.
+ =================================================*/
+struct ShMemCatalogEntry
+{
+	char name[CATALOG_NAME_LEN];
+	uint32_t offset;                  // Offset from the start of the segment
+	uint32_t size;                    // Size requested by the creator
+};
+
+/**
+ * Lives at offset 0 of the segment, entries follow it.
+ =================================================*/
+struct ShMemCatalogHeader
+{
+	uint32_t state;                   // CATALOG_STATE_*
+	uint32_t magic;
+	uint32_t maxEntries;
+	uint32_t numEntries;              // Published with release semantic
+	uint32_t nextOffset;              // First free byte of the data area
+	uint32_t segmentSize;
+	pthread_mutex_t lock;             // Serializes create()
+};
+
+/**
+ * Maps names to offsets and sizes inside a single ShMemXp segment, so
+ * an application attaches all of its shared state with one
+ * shm_open/ftruncate/mmap instead of one per object.
+ *
+ * lookup() is lock free, create() takes a process-shared mutex that
+ * lives in the catalog header. Regions are never removed; the whole
+ * segment is released with unlink().
+ =================================================*/
+class ShMemCatalogXp
+{
+	public:
+		/**
+		 * name: name of the shared memory segment
+		 * size: total size of the segment (header + regions)
+		 * maxEntries: used only by the process that initializes the catalog
+		 * Throws ETIMEDOUT if another process started to initialize the
+		 * catalog and did not finish within CATALOG_INIT_WAIT_MS (it
+		 * probably died); unlink and recreate the segment then.
+		 =================================================*/
+		ShMemCatalogXp(const char* name, int size, int maxEntries = CATALOG_MAX_ENTRIES);
+
+		~ShMemCatalogXp();
+
+		/**
+		 * Returns address of the region or NULL if it does not exist.
+		 * If size is not NULL, size of the region is written to it.
+		 =================================================*/
+		void* lookup(const char* name, int* size = NULL);
+
+		/**
+		 * Returns address of the region, creating it if it is absent.
+		 * New regions are zero filled. Throws if an existing region is
+		 * smaller than size or if the catalog is full.
+		 =================================================*/
+		void* create(const char* name, int size);
+
+		int getEntryCount() const;
+
+		int getFreeSize() const;
+
+		int unlink();
+
+		/**
+		 * ShMemXp::restore() of the segment followed by a fresh catalog
+		 * lock. Call at startup, before other processes attach. Write
+		 * checkpoints with getShm()->checkpoint().
+		 * Returns 0 on success, -1 if there is no valid checkpoint.
+		 =================================================*/
+		int restore(const char* path);
+
+		inline ShMemXp* getShm() { return &_shm; };
+
+		inline int getErrnoError() const { return _errno; };
+
+	private:
+
+		void initialize(int maxEntries);
+
+		void initLock();
+
+		void* find(const char* name, int* size) const;
+
+		ShMemXp _shm;
+
+		ShMemCatalogHeader* _header;
+
+		ShMemCatalogEntry* _entries;
+
+		char* _base;
+
+		int _errno;
+};
+
+#endif
@@ -0,0 +1,229 @@
+//==============================================================================
+// ShMemFdXp.cpp - Anonymous (memfd) shared memory wrapper class.
+// Xenomai-version : 2.6.4
+// Compatibility   : Linux >= 3.17, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Require size seals on receive
+//==============================================================================
+#include "ShMemFdXp.hpp"
+
+ShMemFdXp::ShMemFdXp(const char* name, int size, bool seal){
+	_shmMem = NULL;
+	_shmSize = size;
+	_errno = 0;
+
+	_shmFd = memfd_create(name, MFD_CLOEXEC | MFD_ALLOW_SEALING);
+
+	if(_shmFd == -1){
+		_errno = errno;
+		throw ZnmException("Creating anonymous memory failed", "memfd_create()", _errno);
+	}
+
+	// Set size of memory
+	if(ftruncate(_shmFd, _shmSize) == -1){
+		_errno = errno;
+		::close(_shmFd);
+		throw ZnmException("Setting size of memory failed", "ftruncate()", _errno);
+	}
+
+	if(seal){
+		try{
+			this->seal();
+		}catch(...){
+			::close(_shmFd);
+			throw;
+		}
+	}
+
+	map();
+}
+
+ShMemFdXp::ShMemFdXp(int fd, bool requireSeal){
+	struct stat st;
+	int seals;
+
+	_shmMem = NULL;
+	_shmFd = fd;
+	_errno = 0;
+
+	// An unsealed segment can be shrunk by the peer after we map it,
+	// and touching the lost pages raises SIGBUS
+	if(requireSeal){
+		seals = fcntl(_shmFd, F_GET_SEALS);
+
+		if(seals == -1 || (seals & (SEAL_SIZE_FLAGS)) != (SEAL_SIZE_FLAGS)){
+			_errno = seals == -1 ? errno : EPERM;
+			::close(_shmFd);
+			throw ZnmException("Received memory is not sealed", "ShMemFdXp()", _errno);
+		}
+	}
+
+	// Size comes from the creator, sealed segments can not change it
+	if(fstat(_shmFd, &st) == -1){
+		_errno = errno;
+		::close(_shmFd);
+		throw ZnmException("Reading size of memory failed", "fstat()", _errno);
+	}
+
+	_shmSize = st.st_size;
+
+	map();
+}
+
+ShMemFdXp::~ShMemFdXp(){
+	if(_shmMem != NULL)
+		munmap(_shmMem, _shmSize);
+
+	if(_shmFd != -1)
+		::close(_shmFd);
+}
+
+void ShMemFdXp::map(){
+	_shmMem = mmap(NULL,
+					_shmSize,
+					PROTECTION,
+					MAP_SHARED,
+					_shmFd,
+					0);
+
+	if(_shmMem == MAP_FAILED){
+		_errno = errno;
+		_shmMem = NULL;
+		::close(_shmFd);
+		throw ZnmException("Mapping failed", "mmap()", _errno);
+	}
+}
+
+int ShMemFdXp::seal(){
+	if(fcntl(_shmFd, F_ADD_SEALS, SEAL_ALL_FLAGS) == -1){
+		_errno = errno;
+		throw ZnmException("Sealing memory failed", "seal()", _errno);
+	}
+
+	_errno = 0;
+	return 0;
+}
+
+bool ShMemFdXp::isSealed(){
+	int seals;
+
+	seals = fcntl(_shmFd, F_GET_SEALS);
+
+	if(seals == -1){
+		_errno = errno;
+		throw ZnmException("Reading seals failed", "isSealed()", _errno);
+	}
+
+	_errno = 0;
+	return (seals & (SEAL_SIZE_FLAGS)) == (SEAL_SIZE_FLAGS);
+}
+
+int ShMemFdXp::sendTo(int sock){
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char data = 0;
+	char control[CMSG_SPACE(sizeof(int))];
+
+	memset(&msg, 0, sizeof(msg));
+	memset(control, 0, sizeof(control));
+
+	// At least one byte of real data must be sent with the descriptor
+	iov.iov_base = &data;
+	iov.iov_len = sizeof(data);
+
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+	cmsg->cmsg_level = SOL_SOCKET;
+	cmsg->cmsg_type = SCM_RIGHTS;
+	cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+	memcpy(CMSG_DATA(cmsg), &_shmFd, sizeof(int));
+
+	if(sendmsg(sock, &msg, MSG_NOSIGNAL) == -1){
+		_errno = errno;
+		throw ZnmException("Sending descriptor failed", "sendTo()", _errno);
+	}
+
+	_errno = 0;
+	return 0;
+}
+
+void ShMemFdXp::closeReceived(struct msghdr* msg){
+	struct cmsghdr *cmsg;
+	int count;
+	int fd;
+
+	// Descriptors of a rejected message are already installed in our table
+	for(cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)){
+		if(cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+			continue;
+
+		count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+
+		for(int i = 0; i < count; i++){
+			memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+			::close(fd);
+		}
+	}
+}
+
+int ShMemFdXp::receiveFrom(int sock){
+	struct msghdr msg;
+	struct iovec iov;
+	struct cmsghdr *cmsg;
+	char data;
+	char control[CMSG_SPACE(sizeof(int))];
+	int fd = -1;
+	ssize_t ret;
+
+	memset(&msg, 0, sizeof(msg));
+
+	iov.iov_base = &data;
+	iov.iov_len = sizeof(data);
+
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+
+	ret = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+
+	if(ret == -1)
+		throw ZnmException("Receiving descriptor failed", "receiveFrom()", errno);
+
+	if(ret == 0)
+		throw ZnmException("Peer closed socket", "receiveFrom()", ECONNRESET);
+
+	cmsg = CMSG_FIRSTHDR(&msg);
+
+	// Exactly one descriptor, and none dropped by the kernel for lack
+	// of room (MSG_CTRUNC)
+	if((msg.msg_flags & MSG_CTRUNC) ||
+	   cmsg == NULL ||
+	   cmsg->cmsg_level != SOL_SOCKET ||
+	   cmsg->cmsg_type != SCM_RIGHTS ||
+	   cmsg->cmsg_len != CMSG_LEN(sizeof(int)) ||
+	   CMSG_NXTHDR(&msg, cmsg) != NULL){
+		closeReceived(&msg);
+		throw ZnmException("No single descriptor in message", "receiveFrom()", EBADMSG);
+	}
+
+	memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+
+	return fd;
+}
+
+void* ShMemFdXp::getShmAddr(){
+	return _shmMem;
+}
+
+int ShMemFdXp::getShmSize(){
+	return _shmSize;
+}
@@ -0,0 +1,105 @@
+//==============================================================================
+// ShMemFdXp.hpp - Anonymous (memfd) shared memory wrapper class.
+// Xenomai-version : 2.6.4
+// Compatibility   : Linux >= 3.17, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Require size seals on receive
+//==============================================================================
+
+#ifndef _SHMEMFD_HPP_INCLUDED
+#define _SHMEMFD_HPP_INCLUDED
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include "ShMemXp.hpp"
+#include "znmException.hpp"
+
+#define SEAL_SIZE_FLAGS F_SEAL_SHRINK | F_SEAL_GROW // Size can not change anymore
+#define SEAL_ALL_FLAGS F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL
+
+/**
+ * Shared memory backed by memfd_create instead of a /dev/shm name.
+ *
+ * The segment has no global name, it is handed to peers as a file
+ * descriptor over a unix domain socket (SCM_RIGHTS) and is freed by the
+ * kernel when the last descriptor and mapping are gone, so a crashed
+ * process leaves nothing behind.
+ *
+ * A sealed segment can not be resized by anyone, so peers can map the
+ * size reported by fstat() without guarding against SIGBUS.
+ =================================================*/
+class ShMemFdXp
+{
+	public:
+		/**
+		 * Creates a new anonymous segment.
+		 * name: only used for debugging (/proc/<pid>/fd)
+		 * seal: seal the size right after creation
+		 =================================================*/
+		ShMemFdXp(const char* name, int size, bool seal = true);
+
+		/**
+		 * Maps a segment received from a peer. Takes ownership of fd,
+		 * also when it throws.
+		 * requireSeal: throw EPERM unless the size is sealed. Only pass
+		 * false for a trusted peer, an unsealed segment shrunk by it
+		 * raises SIGBUS on access.
+		 =================================================*/
+		ShMemFdXp(int fd, bool requireSeal = true);
+
+		~ShMemFdXp();
+
+		void* getShmAddr();
+
+		int getShmSize();
+
+		inline int getFd() const { return _shmFd; };
+
+		/**
+		 * Seals size of the segment and the seal set itself.
+		 =================================================*/
+		int seal();
+
+		/**
+		 * Returns true if size of the segment is sealed.
+		 =================================================*/
+		bool isSealed();
+
+		/**
+		 * Sends descriptor of the segment over a connected AF_UNIX socket.
+		 =================================================*/
+		int sendTo(int sock);
+
+		/**
+		 * Receives a segment descriptor sent with sendTo().
+		 * Returns the descriptor, to be passed to ShMemFdXp(int fd).
+		 * Throws EBADMSG if the message carried no descriptor or more
+		 * than one.
+		 =================================================*/
+		static int receiveFrom(int sock);
+
+		inline int getErrnoError() const { return _errno; };
+
+	private:
+
+		void map();
+
+		static void closeReceived(struct msghdr* msg);
+
+		int _shmFd;
+
+		int _shmSize;
+
+		void* _shmMem;
+
+		int _errno;
+};
+
+#endif
@@ -0,0 +1,348 @@
+//==============================================================================
+// ShMemHashMapXp.hpp - Fixed capacity hash map resident in shared memory.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Bounded waits for dead writers
+// 19.10.2026   1.2                                 Time based wait bound with sleeping backoff
+//==============================================================================
+
+#ifndef _SHMEMHASHMAP_HPP_INCLUDED
+#define _SHMEMHASHMAP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+#include "znmException.hpp"
+#include "DeadlineXp.hpp"
+
+#define HASHMAP_MAGIC 0x5A4E4D48     // "ZNMH", marks an initialized map
+#define HASHMAP_STRIPES 16           // Number of writer locks
+#define HASHMAP_EMPTY_KEY 0          // Reserved, marks a free slot
+#define HASHMAP_WAIT_LIMIT_MS 1000   // Wait before a stuck writer is reported
+#define HASHMAP_WAIT_YIELDS 16       // Yields before waiting sleeps
+#define HASHMAP_WAIT_SLEEP_NS 50000  // Sleep per retry after the yields
+
+#define HASHMAP_STATE_EMPTY 0
+#define HASHMAP_STATE_INITIALIZING 1
+#define HASHMAP_STATE_READY 2
+
+/**
+ * Fixed capacity open addressing (linear probing) hash map that lives in
+ * a shared memory region, e.g. ShMemXp::getShmAddr() or a region of a
+ * ShMemCatalogXp. All processes mapping the region share one table.
+ *
+ * Keys are non-zero 64 bit integers (hash strings before inserting),
+ * values are plain data types that can be copied with memcpy.
+ *
+ * find() is lock free: every slot carries a sequence counter that is odd
+ * while the value is being written, readers retry if it changed under
+ * them. insert() serializes writers of the same key with one of
+ * HASHMAP_STRIPES process-shared mutexes and claims free slots with a
+ * CAS, so writers of different keys proceed in parallel. If only one
+ * thread ever writes, pass singleWriter = true to skip the locks.
+ * Stripe mutexes are robust: if a writer dies in insert(), the next
+ * writer of that stripe closes the half written slot (its value may be
+ * torn) so readers do not wait on it forever.
+ *
+ * Readers and processes waiting for the initializer give up after
+ * HASHMAP_WAIT_LIMIT_MS and throw ETIMEDOUT. They yield a few times and
+ * then sleep between retries, so a preempted writer of lower priority
+ * on the same CPU gets to finish. With singleWriter
+ * nothing repairs a slot whose writer died in insert(): find() of that
+ * key throws until the process recreates the map.
+ *
+ * Entries can not be removed, the map is sized once at creation.
+ =================================================*/
+template <typename V>
+class ShMemHashMapXp
+{
+	public:
+		/**
+		 * region: zero filled shared memory, at least requiredSize(capacity)
+		 * capacity: used only by the process that initializes the map,
+		 *           rounded up to a power of two
+		 =================================================*/
+		ShMemHashMapXp(void* region, int regionSize, int capacity, bool singleWriter = false);
+
+		static int requiredSize(int capacity);
+
+		/**
+		 * Copies value of key to value. Returns false if key is absent.
+		 * Throws ETIMEDOUT if the value stays half written.
+		 =================================================*/
+		bool find(uint64_t key, V* value) const;
+
+		/**
+		 * Inserts key or updates its value. Throws ENOSPC if the map is full.
+		 =================================================*/
+		int insert(uint64_t key, const V& value);
+
+		inline int getCount() const { return __atomic_load_n(&_header->count, __ATOMIC_RELAXED); };
+
+		inline int getCapacity() const { return _header->capacity; };
+
+	private:
+
+		struct Header
+		{
+			uint32_t state;          // HASHMAP_STATE_*
+			uint32_t magic;
+			uint32_t capacity;       // Power of two
+			uint32_t count;
+			pthread_mutex_t stripes[HASHMAP_STRIPES];
+		};
+
+		struct Slot
+		{
+			uint64_t key;            // HASHMAP_EMPTY_KEY if free
+			uint32_t seq;            // Odd while writing, 0 until first write
+			V value;
+		};
+
+		static uint32_t roundCapacity(int capacity);
+
+		static uint64_t hash(uint64_t key);
+
+		void initialize(int regionSize, int capacity);
+
+		void writeValue(Slot* slot, const V& value);
+
+		void lockStripe(pthread_mutex_t* stripe);
+
+		/**
+		 * One retry of a wait for another writer. Throws ETIMEDOUT once
+		 * HASHMAP_WAIT_LIMIT_MS passed since the first retry (retries = 0).
+		 =================================================*/
+		static void backoff(int* retries, int64_t* deadline, const char* what, const char* fname);
+
+		Header* _header;
+
+		Slot* _slots;
+
+		bool _singleWriter;
+};
+
+
+template <typename V>
+ShMemHashMapXp<V>::ShMemHashMapXp(void* region, int regionSize, int capacity, bool singleWriter){
+	_header = (Header*) region;
+	_slots = (Slot*) ((char*) region + sizeof(Header));
+	_singleWriter = singleWriter;
+
+	initialize(regionSize, capacity);
+}
+
+template <typename V>
+uint32_t ShMemHashMapXp<V>::roundCapacity(int capacity){
+	uint32_t rounded = 1;
+
+	while(rounded < (uint32_t) capacity)
+		rounded <<= 1;
+
+	return rounded;
+}
+
+template <typename V>
+int ShMemHashMapXp<V>::requiredSize(int capacity){
+	return sizeof(Header) + roundCapacity(capacity) * sizeof(Slot);
+}
+
+template <typename V>
+uint64_t ShMemHashMapXp<V>::hash(uint64_t key){
+	// splitmix64 finalizer, spreads sequential IDs over the table
+	key ^= key >> 30;
+	key *= 0xbf58476d1ce4e5b9ULL;
+	key ^= key >> 27;
+	key *= 0x94d049bb133111ebULL;
+	key ^= key >> 31;
+	return key;
+}
+
+template <typename V>
+void ShMemHashMapXp<V>::initialize(int regionSize, int capacity){
+	uint32_t expected = HASHMAP_STATE_EMPTY;
+
+	if(__atomic_compare_exchange_n(&_header->state, &expected, HASHMAP_STATE_INITIALIZING,
+								false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+
+		if(capacity <= 0 || requiredSize(capacity) > regionSize){
+			__atomic_store_n(&_header->state, HASHMAP_STATE_EMPTY, __ATOMIC_RELEASE);
+			throw ZnmException("Region too small for hash map", "initialize()", EINVAL);
+		}
+
+		pthread_mutexattr_t attr;
+		ERROR_CHECK_RET( pthread_mutexattr_init(&attr), "ShMemHashMapXp", "pthread_mutexattr_init");
+		ERROR_CHECK_RET( pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED), "ShMemHashMapXp", "pthread_mutexattr_setpshared");
+		ERROR_CHECK_RET( pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST), "ShMemHashMapXp", "pthread_mutexattr_setrobust");
+		for(int i = 0; i < HASHMAP_STRIPES; i++)
+			ERROR_CHECK_RET( pthread_mutex_init(&_header->stripes[i], &attr), "ShMemHashMapXp", "pthread_mutex_init");
+		pthread_mutexattr_destroy(&attr);
+
+		_header->magic = HASHMAP_MAGIC;
+		_header->capacity = roundCapacity(capacity);
+		_header->count = 0;
+		memset(_slots, 0, _header->capacity * sizeof(Slot));
+
+		__atomic_store_n(&_header->state, HASHMAP_STATE_READY, __ATOMIC_RELEASE);
+	}else{
+		// The initializer may have died, do not wait for it forever
+		int retries = 0;
+		int64_t deadline = 0;
+		while(__atomic_load_n(&_header->state, __ATOMIC_ACQUIRE) != HASHMAP_STATE_READY)
+			backoff(&retries, &deadline, "Hash map initializer does not finish", "initialize()");
+	}
+
+	if(_header->magic != HASHMAP_MAGIC)
+		throw ZnmException("Region is not a hash map", "initialize()", EINVAL);
+
+	if(requiredSize(_header->capacity) > regionSize)
+		throw ZnmException("Region smaller than hash map", "initialize()", EINVAL);
+}
+
+template <typename V>
+bool ShMemHashMapXp<V>::find(uint64_t key, V* value) const{
+	uint32_t mask = _header->capacity - 1;
+	uint64_t h = hash(key);
+	uint32_t seq1;
+	uint32_t seq2;
+	uint64_t slotKey;
+	const Slot* slot;
+	int retries;
+	int64_t deadline = 0;
+
+	for(uint32_t i = 0; i <= mask; i++){
+		slot = &_slots[(h + i) & mask];
+		slotKey = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+		if(slotKey == HASHMAP_EMPTY_KEY)
+			return false;
+
+		if(slotKey != key)
+			continue;
+
+		// Seqlock read of the value
+		retries = 0;
+		do{
+			seq1 = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+			if(seq1 == 0)
+				return false;	// Slot claimed but value not published yet
+			if(seq1 & 1){
+				// Writer preempted or dead, see class comment
+				backoff(&retries, &deadline, "Hash map slot stays locked", "find()");
+				continue;
+			}
+			memcpy(value, &slot->value, sizeof(V));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			seq2 = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+		}while((seq1 & 1) || seq1 != seq2);
+
+		return true;
+	}
+
+	return false;
+}
+
+template <typename V>
+void ShMemHashMapXp<V>::backoff(int* retries, int64_t* deadline, const char* what, const char* fname){
+	struct timespec pause;
+
+	// Counting yields is no bound: a reader of higher priority yields
+	// only to its peers, never to the writer it waits for
+	if(*retries == 0)
+		*deadline = DeadlineXp(TimeoutXp::milliseconds(HASHMAP_WAIT_LIMIT_MS)).getNanoseconds();
+	else if(DeadlineXp::now().getNanoseconds() >= *deadline)
+		throw ZnmException(what, fname, ETIMEDOUT);
+
+	if(++(*retries) <= HASHMAP_WAIT_YIELDS){
+		sched_yield();
+	}else{
+		pause.tv_sec = 0;
+		pause.tv_nsec = HASHMAP_WAIT_SLEEP_NS;
+		nanosleep(&pause, NULL);
+	}
+}
+
+template <typename V>
+void ShMemHashMapXp<V>::writeValue(Slot* slot, const V& value){
+	uint32_t seq = __atomic_load_n(&slot->seq, __ATOMIC_RELAXED);
+
+	__atomic_store_n(&slot->seq, seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&slot->value, &value, sizeof(V));
+	__atomic_store_n(&slot->seq, seq + 2, __ATOMIC_RELEASE);
+}
+
+template <typename V>
+void ShMemHashMapXp<V>::lockStripe(pthread_mutex_t* stripe){
+	int ret;
+	uint32_t seq;
+
+	ret = pthread_mutex_lock(stripe);
+
+	if(ret == EOWNERDEAD){
+		// Previous writer died, it may have left an odd sequence
+		for(uint32_t i = 0; i < _header->capacity; i++){
+			if(_slots[i].key == HASHMAP_EMPTY_KEY ||
+			   &_header->stripes[hash(_slots[i].key) % HASHMAP_STRIPES] != stripe)
+				continue;
+
+			seq = __atomic_load_n(&_slots[i].seq, __ATOMIC_RELAXED);
+			if(seq & 1)
+				__atomic_store_n(&_slots[i].seq, seq + 1, __ATOMIC_RELEASE);
+		}
+
+		ret = pthread_mutex_consistent(stripe);
+	}
+
+	ERROR_CHECK_RET( ret, "ShMemHashMapXp", "pthread_mutex_lock");
+}
+
+template <typename V>
+int ShMemHashMapXp<V>::insert(uint64_t key, const V& value){
+	uint32_t mask = _header->capacity - 1;
+	uint64_t h = hash(key);
+	pthread_mutex_t* stripe = &_header->stripes[h % HASHMAP_STRIPES];
+	uint64_t slotKey;
+	Slot* slot;
+
+	if(key == HASHMAP_EMPTY_KEY)
+		throw ZnmException("Key 0 is reserved", "insert()", EINVAL);
+
+	// All writers of this key take the same stripe
+	if(!_singleWriter)
+		lockStripe(stripe);
+
+	for(uint32_t i = 0; i <= mask; i++){
+		slot = &_slots[(h + i) & mask];
+		slotKey = __atomic_load_n(&slot->key, __ATOMIC_ACQUIRE);
+
+		// Writers of other stripes may claim free slots concurrently
+		if(slotKey == HASHMAP_EMPTY_KEY &&
+		   __atomic_compare_exchange_n(&slot->key, &slotKey, key,
+								false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+			__atomic_add_fetch(&_header->count, 1, __ATOMIC_RELAXED);
+			slotKey = key;
+		}
+
+		if(slotKey == key){
+			writeValue(slot, value);
+
+			if(!_singleWriter)
+				ERROR_CHECK_RET( pthread_mutex_unlock(stripe), "ShMemHashMapXp", "pthread_mutex_unlock");
+			return 0;
+		}
+	}
+
+	if(!_singleWriter)
+		pthread_mutex_unlock(stripe);
+
+	throw ZnmException("Hash map is full", "insert()", ENOSPC);
+}
+
+#endif
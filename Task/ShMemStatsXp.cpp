@@ -0,0 +1,139 @@
+//==============================================================================
+// ShMemStatsXp.cpp - Per-thread resource usage published in shared memory.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Bounded read() retries
+//==============================================================================
+#include "ShMemStatsXp.hpp"
+#include <string.h>
+#include <signal.h>
+#include <sched.h>
+#include <sys/syscall.h>
+
+ShMemStatsXp::ShMemStatsXp(ShMemCatalogXp* catalog, int maxSlots){
+	int size;
+
+	_errno = 0;
+
+	if(maxSlots <= 0){
+		_errno = EINVAL;
+		throw ZnmException("Invalid slot count", "ShMemStatsXp()", _errno);
+	}
+
+	// An existing table is used with its own slot count
+	_slots = (ShMemStatsSlot*) catalog->lookup(STATS_REGION_NAME, &size);
+	if(_slots == NULL){
+		size = maxSlots * sizeof(ShMemStatsSlot);
+		_slots = (ShMemStatsSlot*) catalog->create(STATS_REGION_NAME, size);
+		catalog->lookup(STATS_REGION_NAME, &size);
+	}
+	_numSlots = size / sizeof(ShMemStatsSlot);
+}
+
+ShMemStatsXp::~ShMemStatsXp(){ }
+
+bool ShMemStatsXp::claim(int slot, uint32_t expected){
+	return __atomic_compare_exchange_n(&_slots[slot].state, &expected, STATS_SLOT_USED,
+								false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+int ShMemStatsXp::attach(const char* name){
+	ShMemStatsSlot* s;
+	int slot = -1;
+	pid_t pid;
+
+	for(int i = 0; i < _numSlots && slot < 0; i++){
+		if(claim(i, STATS_SLOT_FREE))
+			slot = i;
+	}
+
+	// Take over a slot whose process is gone
+	for(int i = 0; i < _numSlots && slot < 0; i++){
+		pid = __atomic_load_n(&_slots[i].pid, __ATOMIC_RELAXED);
+		if(pid != 0 && kill(pid, 0) != 0 && errno == ESRCH &&
+		   __atomic_compare_exchange_n(&_slots[i].pid, &pid, getpid(),
+								false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+			slot = i;
+	}
+
+	if(slot < 0){
+		_errno = ENOSPC;
+		return -1;
+	}
+
+	s = &_slots[slot];
+	__atomic_store_n(&s->seq, s->seq | 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	s->pid = getpid();
+	s->tid = syscall(SYS_gettid);
+	memset(s->name, 0, sizeof(s->name));
+	if(name != NULL)
+		strncpy(s->name, name, THREAD_NAME_LEN - 1);
+	memset(&s->usage, 0, sizeof(s->usage));
+	__atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+
+	_errno = 0;
+	return slot;
+}
+
+void ShMemStatsXp::detach(int slot){
+	if(slot < 0 || slot >= _numSlots)
+		return;
+
+	__atomic_store_n(&_slots[slot].pid, 0, __ATOMIC_RELAXED);
+	__atomic_store_n(&_slots[slot].state, STATS_SLOT_FREE, __ATOMIC_RELEASE);
+}
+
+void ShMemStatsXp::publish(int slot, const ThreadUsageXp* usage){
+	ShMemStatsSlot* s;
+
+	if(slot < 0 || slot >= _numSlots)
+		return;
+
+	s = &_slots[slot];
+	__atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(&s->usage, usage, sizeof(s->usage));
+	__atomic_store_n(&s->seq, s->seq + 1, __ATOMIC_RELEASE);
+}
+
+bool ShMemStatsXp::read(int slot, ShMemStatsSlot* out){
+	ShMemStatsSlot* s;
+	uint32_t seq;
+	pid_t pid;
+
+	if(slot < 0 || slot >= _numSlots)
+		return false;
+
+	s = &_slots[slot];
+	for(int tries = 0; ; tries++){
+		seq = __atomic_load_n(&s->seq, __ATOMIC_ACQUIRE);
+
+		if(!(seq & 1)){
+			memcpy(out, s, sizeof(*out));
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			if(__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == seq)
+				break;
+		}
+
+		// A writer that died mid-publish leaves seq odd for good
+		if(tries == STATS_READ_RETRIES){
+			pid = __atomic_load_n(&s->pid, __ATOMIC_RELAXED);
+			_errno = (pid != 0 && kill(pid, 0) != 0 && errno == ESRCH) ? ESRCH : EBUSY;
+			return false;
+		}
+
+		sched_yield();
+	}
+
+	_errno = 0;
+	return out->state == STATS_SLOT_USED;
+}
+
+int ShMemStatsXp::getSlotCount() const{
+	return _numSlots;
+}
@@ -0,0 +1,119 @@
+//==============================================================================
+// ShMemSyncXp.cpp - Synchronization objects resident in shared memory.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Bounded wait for the constructing process
+// 19.10.2026   1.2                                 One construction helper, type tag per slot
+//==============================================================================
+#include "ShMemSyncXp.hpp"
+#include <time.h>
+#include <new>
+
+ShMemSyncXp::ShMemSyncXp(ShMemCatalogXp* catalog){
+	_catalog = catalog;
+}
+
+ShMemSyncXp::~ShMemSyncXp(){ }
+
+void* ShMemSyncXp::beginInit(const char* name, int size, uint32_t type, uint32_t** state){
+	char* region;
+	uint32_t expected;
+	uint32_t* tag;
+	struct timespec pause;
+
+	region = (char*) _catalog->create(name, SYNC_SLOT_HEADER + size);
+	*state = (uint32_t*) region;
+	tag = (uint32_t*) region + 1;
+
+	pause.tv_sec = 0;
+	pause.tv_nsec = 100000;
+
+	for(int waits = 0; ; waits++){
+		expected = SYNC_STATE_EMPTY;
+
+		if(__atomic_compare_exchange_n(*state, &expected, SYNC_STATE_INITIALIZING,
+									false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)){
+			// Published with the object by endInit()
+			*tag = type;
+			break;	// We construct it
+		}
+
+		if(expected == SYNC_STATE_READY){
+			*state = NULL;
+			if(*tag != type)
+				throw ZnmException("Sync object has another type", "beginInit()", EINVAL);
+			break;	// Constructed by someone else
+		}
+
+		// Constructor is running in another thread or process, which
+		// may have died. Sleeping lets it run even at a lower priority.
+		if(waits == SYNC_INIT_WAIT_MS * 10)
+			throw ZnmException("Sync object constructor does not finish", "beginInit()", ETIMEDOUT);
+		nanosleep(&pause, NULL);
+	}
+
+	return region + SYNC_SLOT_HEADER;
+}
+
+void ShMemSyncXp::endInit(uint32_t* state, bool success){
+	// On failure let the next caller try again
+	__atomic_store_n(state, success ? SYNC_STATE_READY : SYNC_STATE_EMPTY, __ATOMIC_RELEASE);
+}
+
+MutexXp* ShMemSyncXp::mutex(const char* name, int type, int proto, int robust){
+	Init<MutexXp> init(this, name, SYNC_TYPE_MUTEX);
+
+	if(init.needed())
+		init.done(new (init.place()) MutexXp(type, proto, PTHREAD_PROCESS_SHARED, robust));
+
+	return init.object();
+}
+
+CondVariableXp* ShMemSyncXp::condVariable(const char* name, clockid_t clk_id){
+	Init<CondVariableXp> init(this, name, SYNC_TYPE_CONDVARIABLE);
+
+	if(init.needed())
+		init.done(new (init.place()) CondVariableXp(clk_id, PTHREAD_PROCESS_SHARED));
+
+	return init.object();
+}
+
+RWLock* ShMemSyncXp::rwLock(const char* name){
+	Init<RWLock> init(this, name, SYNC_TYPE_RWLOCK);
+
+	if(init.needed())
+		init.done(new (init.place()) RWLock(PTHREAD_PROCESS_SHARED));
+
+	return init.object();
+}
+
+PtBarrier* ShMemSyncXp::barrier(const char* name, int n){
+	Init<PtBarrier> init(this, name, SYNC_TYPE_BARRIER);
+
+	if(init.needed())
+		init.done(new (init.place()) PtBarrier(n, PTHREAD_PROCESS_SHARED));
+
+	return init.object();
+}
+
+SpinBarrier* ShMemSyncXp::spinBarrier(const char* name, int n, int spinCount){
+	Init<SpinBarrier> init(this, name, SYNC_TYPE_SPINBARRIER);
+
+	if(init.needed())
+		init.done(new (init.place()) SpinBarrier(n, spinCount, PTHREAD_PROCESS_SHARED));
+
+	return init.object();
+}
+
+SemaphoreXp* ShMemSyncXp::semaphore(const char* name, unsigned int value){
+	Init<SemaphoreXp> init(this, name, SYNC_TYPE_SEMAPHORE);
+
+	if(init.needed())
+		init.done(new (init.place()) SemaphoreXp(value, PTHREAD_PROCESS_SHARED));
+
+	return init.object();
+}
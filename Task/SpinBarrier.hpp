@@ -0,0 +1,151 @@
+//==============================================================================
+// SpinBarrier.hpp - Sense reversing spin/futex barrier.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _SPINBARRIER_HPP_INCLUDED
+#define _SPINBARRIER_HPP_INCLUDED
+
+#include <pthread.h>
+#include <limits.h>
+#include <inttypes.h>
+#include "ErrnoException.hpp"
+#include "FutexXp.hpp"
+
+#define SPIN_BARRIER_SPIN 20000 // Default number of spins before sleeping
+
+//==============================================================================
+// class SpinBarrier
+//------------------------------------------------------------------------------
+// \brief
+// A reusable barrier for threads that meet at every frame of a cyclic
+// computation, with the same use as PtBarrier.
+//
+// <ul>
+// <li>The last thread to arrive releases the others by flipping the
+//     barrier generation (the "sense"); waiters spin on it for up to
+//     spinCount iterations and only then sleep in the kernel (futex).
+//     With pinned threads that arrive close together no thread enters
+//     the kernel and release takes a cache line transfer.
+// <li>The last arriver makes a system call only if some waiter already
+//     went to sleep.
+// <li>The barrier can be reused right away, a thread may call wait()
+//     for the next frame before all others have left the previous one.
+// <li>Can be placed in shared memory with pshared set to
+//     PTHREAD_PROCESS_SHARED (see ShMemSyncXp::spinBarrier()).
+// <li>This class will throw an exception of type ErrnoException in case of
+//     errors.
+// </ul>
+//==============================================================================
+
+class SpinBarrier
+{
+ public:
+  inline SpinBarrier(int n, int spinCount = SPIN_BARRIER_SPIN,
+                     int pshared = PTHREAD_PROCESS_PRIVATE);
+   // Initialize a barrier object.
+   //  n          The number of threads that must call wait() before
+   //             any of them returns. Must be greater than 0.
+   //  spinCount  Spins before sleeping; 0 sleeps at once.
+   //  pshared    PTHREAD_PROCESS_SHARED if the barrier lives in
+   //             shared memory and is used by several processes.
+
+  inline bool wait();
+   // Blocks until 'n' threads have called wait().
+   //  return  true in exactly one thread (the last one to arrive),
+   //          like PTHREAD_BARRIER_SERIAL_THREAD.
+
+  inline void setSpinCount(int spinCount);
+
+  //======== END OF INTERFACE ========
+
+ private:
+  inline void errorCheck(int code);
+
+  uint32_t d_arrived;   // Threads arrived in this generation
+  uint32_t d_generation; // Flipped by the last arriver, futex word
+  uint32_t d_sleepers;  // Threads sleeping in the kernel
+  uint32_t d_count;     // Number of participating threads
+  int d_spinCount;
+  bool d_pshared;
+};
+
+
+//==============================================================================
+// SpinBarrier::SpinBarrier
+//==============================================================================
+SpinBarrier::SpinBarrier(int n, int spinCount, int pshared)
+{
+ if (n < 1)
+  n = 1;
+ d_arrived = 0;
+ d_generation = 0;
+ d_sleepers = 0;
+ d_count = n;
+ d_spinCount = (spinCount < 0) ? 0 : spinCount;
+ d_pshared = (pshared == PTHREAD_PROCESS_SHARED);
+}
+
+
+//==============================================================================
+// SpinBarrier::wait
+//==============================================================================
+bool SpinBarrier::wait()
+{
+ uint32_t generation = __atomic_load_n(&d_generation, __ATOMIC_ACQUIRE);
+ int errNumber;
+
+ if(__atomic_add_fetch(&d_arrived, 1, __ATOMIC_ACQ_REL) == d_count)
+ {
+  // Last one: reset for the next frame, then release everybody
+  __atomic_store_n(&d_arrived, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&d_generation, generation + 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&d_sleepers, __ATOMIC_SEQ_CST) != 0)
+   futexWake(&d_generation, INT_MAX, d_pshared);
+  return true;
+ }
+
+ for(int i = 0; i < d_spinCount; i++)
+ {
+  if(__atomic_load_n(&d_generation, __ATOMIC_ACQUIRE) != generation)
+   return false;
+  cpuRelax();
+ }
+
+ __atomic_add_fetch(&d_sleepers, 1, __ATOMIC_SEQ_CST);
+ while(__atomic_load_n(&d_generation, __ATOMIC_SEQ_CST) == generation)
+ {
+  errNumber = futexWait(&d_generation, generation, NULL, CLOCK_MONOTONIC, d_pshared);
+  if(errNumber != 0 && errNumber != EAGAIN && errNumber != EINTR)
+  {
+   __atomic_sub_fetch(&d_sleepers, 1, __ATOMIC_SEQ_CST);
+   errorCheck(errNumber);
+  }
+ }
+ __atomic_sub_fetch(&d_sleepers, 1, __ATOMIC_SEQ_CST);
+ return false;
+}
+
+
+//==============================================================================
+// SpinBarrier::setSpinCount
+//==============================================================================
+void SpinBarrier::setSpinCount(int spinCount)
+{
+ d_spinCount = (spinCount < 0) ? 0 : spinCount;
+}
+
+
+//==============================================================================
+// SpinBarrier::errorCheck
+//==============================================================================
+void SpinBarrier::errorCheck(int code)
+{
+ if(code == 0) return;
+ throw(ErrnoException(code, "[SpinBarrier]"));
+}
+
+#endif // _SPINBARRIER_HPP_INCLUDED
@@ -0,0 +1,363 @@
+//==============================================================================
+// SpinLockXp.hpp - Fair queue spin locks (ticket and MCS).
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _SPINLOCKXP_HPP_INCLUDED
+#define _SPINLOCKXP_HPP_INCLUDED
+
+#include <errno.h>
+#include <inttypes.h>
+#include "FutexXp.hpp"
+#include "znmException.hpp"
+
+#define SPINLOCK_CACHE_LINE 64
+#define SPINLOCK_BACKOFF 32      // Pauses per thread ahead in a ticket lock
+#define MCS_THREAD_NODES 8       // Queue nodes per thread for McsSpinLockXp::lock()
+
+//==============================================================================
+// class TicketSpinLockXp
+//------------------------------------------------------------------------------
+// \brief
+// A FIFO spin lock for very short critical sections between threads
+// pinned to isolated CPUs, where waking a sleeping thread would cost
+// more than the critical section.
+//
+// <ul>
+// <li>Threads get the lock in the order they asked for it; none can be
+//     starved, unlike with a test-and-set lock.
+// <li>A waiter pauses in proportion to the number of threads ahead of it,
+//     so it reads the shared line less often.
+// <li>All waiters spin on the same cache line, so each unlock() costs a
+//     transfer to every waiter. With many waiters use McsSpinLockXp.
+// <li>Never enters the kernel. Do not use it where the holder can be
+//     preempted by a waiter on the same CPU: the waiter would spin for
+//     the rest of its time slice.
+// <li>Contains no pointers and can be placed in shared memory.
+// </ul>
+//==============================================================================
+
+class TicketSpinLockXp
+{
+ public:
+  inline TicketSpinLockXp();
+   // Constructs an unlocked TicketSpinLockXp
+
+  inline void lock();
+   // Spins until the lock is acquired.
+
+  inline void unlock();
+   // Releases the lock to the next thread in line.
+
+  inline int tryLock();
+   // Returns 0 and locks if the lock is free (and nobody is queued),
+   // else returns -1.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  uint32_t d_next;
+   // Next ticket to hand out
+
+  uint32_t d_serving;
+   // Ticket that holds the lock
+} __attribute__((aligned(SPINLOCK_CACHE_LINE)));
+
+
+//==============================================================================
+// class McsSpinLockXp
+//------------------------------------------------------------------------------
+// \brief
+// A FIFO spin lock (Mellor-Crummey and Scott) in which every waiter spins
+// on a queue node of its own.
+//
+// <ul>
+// <li>Waiters form a linked queue. Each spins on a flag in its own node,
+//     which only its predecessor writes, so unlock() transfers one cache
+//     line no matter how many threads are waiting.
+// <li>The node can be given explicitly (lock(Node *) / unlock(Node *)),
+//     typically on the stack of the caller. It must stay valid until the
+//     matching unlock().
+// <li>lock() / unlock() without a node take one from a small pool of the
+//     calling thread (MCS_THREAD_NODES locks can be held at once).
+// <li>Never enters the kernel. Process private only: nodes are linked by
+//     address.
+// <li>This class will throw an exception of type ZnmException in case of
+//     errors.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  McsSpinLockXp::Node node;
+//  lock.lock(&node);
+//  ...
+//  lock.unlock(&node);
+// </pre>
+//==============================================================================
+
+class McsSpinLockXp
+{
+ public:
+  struct Node
+  {
+   Node *next;
+   uint32_t locked;
+   McsSpinLockXp *lock;
+    // Lock the node is queued on, used by the thread pool
+  } __attribute__((aligned(SPINLOCK_CACHE_LINE)));
+
+  inline McsSpinLockXp();
+   // Constructs an unlocked McsSpinLockXp
+
+  inline void lock(Node *node);
+   // Queues node and spins on it until the lock is acquired.
+
+  inline void unlock(Node *node);
+   // Releases the lock taken with node to the next queued thread.
+
+  inline int tryLock(Node *node);
+   // Returns 0 and locks if nobody holds or waits for the lock,
+   // else returns -1.
+
+  inline void lock();
+   // Like lock(Node *), with a node of the calling thread.
+
+  inline void unlock();
+   // Releases a lock taken with lock().
+
+  inline int tryLock();
+   // Like tryLock(Node *), with a node of the calling thread.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  struct NodePool
+  {
+   Node nodes[MCS_THREAD_NODES];
+   uint32_t used;
+    // Bit i set if nodes[i] is in use
+  };
+
+  static inline NodePool *threadPool();
+
+  inline Node *allocNode();
+
+  inline Node *findNode();
+   // Node of the calling thread queued on this lock
+
+  static inline void freeNode(NodePool *pool, Node *node);
+
+  Node *d_tail;
+   // Last node in the queue, NULL if the lock is free
+} __attribute__((aligned(SPINLOCK_CACHE_LINE)));
+
+
+//==============================================================================
+// TicketSpinLockXp::TicketSpinLockXp()
+//==============================================================================
+TicketSpinLockXp::TicketSpinLockXp()
+{
+ d_next = 0;
+ d_serving = 0;
+}
+
+
+//==============================================================================
+// TicketSpinLockXp::lock()
+//==============================================================================
+void TicketSpinLockXp::lock()
+{
+ uint32_t ticket = __atomic_fetch_add(&d_next, 1, __ATOMIC_RELAXED);
+ uint32_t serving;
+
+ while((serving = __atomic_load_n(&d_serving, __ATOMIC_ACQUIRE)) != ticket)
+ {
+  for(uint32_t i = (ticket - serving) * SPINLOCK_BACKOFF; i > 0; i--)
+   cpuRelax();
+ }
+}
+
+
+//==============================================================================
+// TicketSpinLockXp::unlock()
+//==============================================================================
+void TicketSpinLockXp::unlock()
+{
+ // Only the holder writes d_serving
+ __atomic_store_n(&d_serving, d_serving + 1, __ATOMIC_RELEASE);
+}
+
+
+//==============================================================================
+// TicketSpinLockXp::tryLock()
+//==============================================================================
+int TicketSpinLockXp::tryLock()
+{
+ uint32_t ticket = __atomic_load_n(&d_serving, __ATOMIC_RELAXED);
+
+ if(__atomic_compare_exchange_n(&d_next, &ticket, ticket + 1, false,
+                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  return 0;
+ return -1;
+}
+
+
+//==============================================================================
+// McsSpinLockXp::McsSpinLockXp()
+//==============================================================================
+McsSpinLockXp::McsSpinLockXp()
+{
+ d_tail = NULL;
+}
+
+
+//==============================================================================
+// McsSpinLockXp::lock(Node *node)
+//==============================================================================
+void McsSpinLockXp::lock(Node *node)
+{
+ Node *prev;
+
+ node->next = NULL;
+ node->locked = 1;
+
+ prev = __atomic_exchange_n(&d_tail, node, __ATOMIC_ACQ_REL);
+ if(prev == NULL)
+  return;
+
+ __atomic_store_n(&prev->next, node, __ATOMIC_RELEASE);
+ while(__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+  cpuRelax();
+}
+
+
+//==============================================================================
+// McsSpinLockXp::unlock(Node *node)
+//==============================================================================
+void McsSpinLockXp::unlock(Node *node)
+{
+ Node *next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+ Node *expected;
+
+ if(next == NULL)
+ {
+  expected = node;
+  if(__atomic_compare_exchange_n(&d_tail, &expected, (Node *)NULL, false,
+                                 __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+   return;
+
+  // A successor swapped the tail but has not linked itself yet
+  while((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == NULL)
+   cpuRelax();
+ }
+
+ __atomic_store_n(&next->locked, 0, __ATOMIC_RELEASE);
+}
+
+
+//==============================================================================
+// McsSpinLockXp::tryLock(Node *node)
+//==============================================================================
+int McsSpinLockXp::tryLock(Node *node)
+{
+ Node *expected = NULL;
+
+ node->next = NULL;
+ node->locked = 0;
+ if(__atomic_compare_exchange_n(&d_tail, &expected, node, false,
+                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  return 0;
+ return -1;
+}
+
+
+//==============================================================================
+// McsSpinLockXp::lock()
+//==============================================================================
+void McsSpinLockXp::lock()
+{
+ lock(allocNode());
+}
+
+
+//==============================================================================
+// McsSpinLockXp::unlock()
+//==============================================================================
+void McsSpinLockXp::unlock()
+{
+ Node *node = findNode();
+
+ unlock(node);
+ freeNode(threadPool(), node);
+}
+
+
+//==============================================================================
+// McsSpinLockXp::tryLock()
+//==============================================================================
+int McsSpinLockXp::tryLock()
+{
+ Node *node = allocNode();
+
+ if(tryLock(node) == 0)
+  return 0;
+ freeNode(threadPool(), node);
+ return -1;
+}
+
+
+//==============================================================================
+// McsSpinLockXp::threadPool()
+//==============================================================================
+McsSpinLockXp::NodePool *McsSpinLockXp::threadPool()
+{
+ static __thread NodePool pool;
+ return &pool;
+}
+
+
+//==============================================================================
+// McsSpinLockXp::allocNode()
+//==============================================================================
+McsSpinLockXp::Node *McsSpinLockXp::allocNode()
+{
+ NodePool *pool = threadPool();
+ int i = __builtin_ffs(~pool->used) - 1;
+
+ if(i < 0 || i >= MCS_THREAD_NODES)
+  throw(ZnmException("McsSpinLockXp", "lock", ENOSPC));
+
+ pool->used |= 1u << i;
+ pool->nodes[i].lock = this;
+ return &pool->nodes[i];
+}
+
+
+//==============================================================================
+// McsSpinLockXp::findNode()
+//==============================================================================
+McsSpinLockXp::Node *McsSpinLockXp::findNode()
+{
+ NodePool *pool = threadPool();
+
+ for(int i = 0; i < MCS_THREAD_NODES; i++)
+  if((pool->used & (1u << i)) && pool->nodes[i].lock == this)
+   return &pool->nodes[i];
+
+ throw(ZnmException("McsSpinLockXp", "unlock", EPERM));
+}
+
+
+//==============================================================================
+// McsSpinLockXp::freeNode(NodePool *pool, Node *node)
+//==============================================================================
+void McsSpinLockXp::freeNode(NodePool *pool, Node *node)
+{
+ node->lock = NULL;
+ pool->used &= ~(1u << (node - pool->nodes));
+}
+
+#endif // _SPINLOCKXP_HPP_INCLUDED
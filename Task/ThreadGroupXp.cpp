@@ -0,0 +1,177 @@
+//==============================================================================
+// ThreadGroupXp.cpp - Concurrent startup of a set of threads.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "ThreadGroupXp.hpp"
+#include "FutexXp.hpp"
+#include "znmException.hpp"
+
+//==============================================================================
+// ThreadGroupXp::ThreadGroupXp
+//==============================================================================
+ThreadGroupXp::ThreadGroupXp()
+{
+ d_launchStart = 0;
+ d_launchTime = 0;
+ d_remaining = 0;
+ d_launched = false;
+}
+
+
+//==============================================================================
+// ThreadGroupXp::~ThreadGroupXp
+//==============================================================================
+ThreadGroupXp::~ThreadGroupXp()
+{
+}
+
+
+//==============================================================================
+// ThreadGroupXp::add
+//==============================================================================
+void ThreadGroupXp::add(ThreadXp *thread, void *arg /*= NULL*/)
+{
+ Member m;
+
+ if(thread == NULL)
+  throw ZnmException("ThreadGroupXp", "add", EINVAL);
+ if(d_launched)
+  throw ZnmException("ThreadGroupXp", "add", EBUSY);
+
+ m.thread = thread;
+ m.arg = arg;
+ m.group = this;
+ m.started = 0;
+ m.code = 0;
+ d_members.push_back(m);
+}
+
+
+//==============================================================================
+// ThreadGroupXp::launch
+//==============================================================================
+int ThreadGroupXp::launch()
+{
+ uint32_t remaining;
+ int errNumber;
+ int first = 0;
+
+ if(d_launched)
+  return EBUSY;
+ d_launched = true;
+
+ // d_members does not change from here on, so its elements stay put
+ __atomic_store_n(&d_remaining, d_members.size(), __ATOMIC_RELAXED);
+ d_launchStart = DeadlineXp::now().getNanoseconds();
+
+ for(size_t i = 0; i < d_members.size(); i++)
+ {
+  Member &m = d_members[i];
+
+  m.code = m.thread->launch(m.arg, ThreadGroupXp::started, &m);
+  if(m.code != 0)
+  {
+   if(first == 0)
+    first = m.code;
+   __atomic_sub_fetch(&d_remaining, 1, __ATOMIC_ACQ_REL);
+  }
+ }
+
+ // One wait for all, the last thread to start wakes us
+ while((remaining = __atomic_load_n(&d_remaining, __ATOMIC_ACQUIRE)) != 0)
+ {
+  errNumber = futexWait(&d_remaining, remaining);
+  if(errNumber != 0 && errNumber != EAGAIN && errNumber != EINTR)
+   throw(ZnmException("ThreadGroupXp", "futex_wait", errNumber));
+ }
+
+ d_launchTime = DeadlineXp::now().getNanoseconds() - d_launchStart;
+ return first;
+}
+
+
+//==============================================================================
+// ThreadGroupXp::joinAll
+//==============================================================================
+void ThreadGroupXp::joinAll()
+{
+ for(size_t i = 0; i < d_members.size(); i++)
+  if(d_launched && d_members[i].code == 0)
+   d_members[i].thread->join();
+}
+
+
+//==============================================================================
+// ThreadGroupXp::cancelAll
+//==============================================================================
+void ThreadGroupXp::cancelAll()
+{
+ for(size_t i = 0; i < d_members.size(); i++)
+  if(d_launched && d_members[i].code == 0)
+   d_members[i].thread->cancel();
+}
+
+
+//==============================================================================
+// ThreadGroupXp::size
+//==============================================================================
+int ThreadGroupXp::size() const
+{
+ return d_members.size();
+}
+
+
+//==============================================================================
+// ThreadGroupXp::get
+//==============================================================================
+ThreadXp *ThreadGroupXp::get(int index) const
+{
+ if(index < 0 || index >= (int)d_members.size())
+  return NULL;
+ return d_members[index].thread;
+}
+
+
+//==============================================================================
+// ThreadGroupXp::getStartLatency
+//==============================================================================
+int64_t ThreadGroupXp::getStartLatency(int index) const
+{
+ int64_t started;
+
+ if(index < 0 || index >= (int)d_members.size())
+  return -1;
+ started = __atomic_load_n(&d_members[index].started, __ATOMIC_ACQUIRE);
+ if(started == 0)
+  return -1;
+ return started - d_launchStart;
+}
+
+
+//==============================================================================
+// ThreadGroupXp::getLaunchTime
+//==============================================================================
+TimeoutXp ThreadGroupXp::getLaunchTime() const
+{
+ return TimeoutXp(d_launchTime);
+}
+
+
+//==============================================================================
+// ThreadGroupXp::started
+//==============================================================================
+void ThreadGroupXp::started(void *member)
+{
+ Member *m = (Member *)member;
+ uint32_t *remaining = &m->group->d_remaining;
+
+ __atomic_store_n(&m->started, DeadlineXp::now().getNanoseconds(), __ATOMIC_RELEASE);
+ // The decrement is the last access to the group: launch() may return
+ // and the group go away before the wake, which then finds no waiter
+ if(__atomic_sub_fetch(remaining, 1, __ATOMIC_ACQ_REL) == 0)
+  futexWake(remaining, 1);
+}
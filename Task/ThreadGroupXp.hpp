@@ -0,0 +1,111 @@
+//==============================================================================
+// ThreadGroupXp.hpp - Concurrent startup of a set of threads.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _THREADGROUPXP_HPP_INCLUDED
+#define _THREADGROUPXP_HPP_INCLUDED
+
+#include <inttypes.h>
+#include <vector>
+#include "ThreadXp.hpp"
+#include "DeadlineXp.hpp"
+
+//==============================================================================
+// class ThreadGroupXp
+//------------------------------------------------------------------------------
+// \brief
+// Starts many ThreadXp objects at once.
+//
+// ThreadXp::run() returns only after enterThread() of the new thread has
+// finished, so starting n threads with run() costs n thread startups one
+// after the other. launch() creates all threads without waiting and then
+// waits once until every enterThread() has finished.
+//
+// <ul>
+// <li>The group does not own the threads; they must outlive it or be
+//     joined with joinAll().
+// <li>The start latency of a thread is the time from launch() until its
+//     enterThread() finished, see getStartLatency().
+// <li>A thread that could not be created does not block launch(); its
+//     latency is -1.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  ThreadGroupXp group;
+//  for(int i = 0; i < 64; i++)
+//   group.add(workers[i], &args[i]);
+//  group.launch();
+//  ...
+//  group.joinAll();
+// </pre>
+//==============================================================================
+
+class ThreadGroupXp
+{
+ public:
+  ThreadGroupXp();
+
+  ~ThreadGroupXp();
+
+  void add(ThreadXp *thread, void *arg = NULL);
+   // Adds a thread to start. Throws ZnmException with EINVAL for a
+   // NULL thread and EBUSY after launch().
+   //  arg     Passed to the thread as by run().
+
+  int launch();
+   // Creates all threads and returns when every enterThread() that
+   // was started has finished.
+   //  return  0 on success, else the errno code of the first thread
+   //          that could not be created.
+
+  void joinAll();
+   // Joins all started threads.
+
+  void cancelAll();
+   // Cancels all started threads.
+
+  int size() const;
+
+  ThreadXp *get(int index) const;
+
+  int64_t getStartLatency(int index) const;
+   //  return  ns from launch() until enterThread() of the thread
+   //          finished, -1 if the thread was not started.
+
+  TimeoutXp getLaunchTime() const;
+   //  return  duration of the last launch().
+
+  //======== END OF INTERFACE ========
+
+ private:
+  struct Member
+  {
+   ThreadXp *thread;
+   void *arg;
+   ThreadGroupXp *group;
+   int64_t started;
+    // Monotonic ns, 0 until enterThread() finished
+   int code;
+  };
+
+  static void started(void *member);
+
+  std::vector<Member> d_members;
+
+  int64_t d_launchStart;
+  int64_t d_launchTime;
+
+  uint32_t d_remaining;
+   // Threads whose enterThread() has not finished yet. The last one
+   // wakes launch() after its decrement, possibly when the group is
+   // gone: a futex wake on a dead word is harmless, as in sem_post().
+
+  bool d_launched;
+};
+
+#endif // _THREADGROUPXP_HPP_INCLUDED
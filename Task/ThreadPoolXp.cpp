@@ -0,0 +1,476 @@
+//==============================================================================
+// ThreadPoolXp.cpp - Work stealing thread pool.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "ThreadPoolXp.hpp"
+#include "znmException.hpp"
+#include <unistd.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <new>
+
+#define JOB_PENDING 0
+#define JOB_DONE 1
+#define JOB_WAITING 2
+
+static __thread ThreadPoolXp *t_pool = NULL;
+ // Pool of the calling worker thread
+static __thread int t_worker = -1;
+ // Index of the calling worker thread in t_pool
+
+
+//==============================================================================
+// class ThreadPoolXp::Worker
+//==============================================================================
+class ThreadPoolXp::Worker : public ThreadXp
+{
+ public:
+  Worker(ThreadPoolXp *pool, int index, int policy, int sched_priority,
+         size_t stacksize)
+   : ThreadXp(PTHREAD_CREATE_JOINABLE, stacksize, PTHREAD_EXPLICIT_SCHED,
+              policy, sched_priority, "pool-worker"),
+     d_pool(pool), d_index(index) {}
+
+ protected:
+  virtual void enterThread(void * /*arg*/)
+  {
+   t_pool = d_pool;
+   t_worker = d_index;
+  }
+
+  virtual int executeInThread(void * /*arg*/)
+  {
+   d_pool->workerLoop(d_index);
+   return 0;
+  }
+
+  virtual void exitThread(void * /*arg*/) {}
+
+ private:
+  ThreadPoolXp *d_pool;
+  int d_index;
+};
+
+
+//==============================================================================
+// JobXp::JobXp
+//==============================================================================
+JobXp::JobXp()
+{
+ d_state = JOB_DONE;
+ d_failed = false;
+}
+
+
+//==============================================================================
+// JobXp::~JobXp
+//==============================================================================
+JobXp::~JobXp()
+{
+}
+
+
+//==============================================================================
+// JobXp::wait
+//==============================================================================
+void JobXp::wait()
+{
+ uint32_t state;
+ int errNumber;
+
+ ThreadPoolXp::helpUntilDone(this);
+
+ state = __atomic_load_n(&d_state, __ATOMIC_ACQUIRE);
+ while(state != JOB_DONE)
+ {
+  if(state == JOB_PENDING &&
+     !__atomic_compare_exchange_n(&d_state, &state, JOB_WAITING, false,
+                                  __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+   continue;
+
+  errNumber = futexWait(&d_state, JOB_WAITING);
+  if(errNumber != 0 && errNumber != EAGAIN && errNumber != EINTR)
+   throw(ZnmException("JobXp", "futex_wait", errNumber));
+  state = __atomic_load_n(&d_state, __ATOMIC_ACQUIRE);
+ }
+}
+
+
+//==============================================================================
+// JobXp::isDone
+//==============================================================================
+bool JobXp::isDone()
+{
+ return __atomic_load_n(&d_state, __ATOMIC_ACQUIRE) == JOB_DONE;
+}
+
+
+//==============================================================================
+// JobXp::failed
+//==============================================================================
+bool JobXp::failed()
+{
+ return d_failed;
+}
+
+
+//==============================================================================
+// JobXp::complete
+//==============================================================================
+void JobXp::complete(bool failed)
+{
+ d_failed = failed;
+ // The job may be destroyed as soon as it is seen done
+ if(__atomic_exchange_n(&d_state, JOB_DONE, __ATOMIC_ACQ_REL) == JOB_WAITING)
+  futexWake(&d_state, INT_MAX);
+}
+
+
+//==============================================================================
+// FunctionJobXp::FunctionJobXp
+//==============================================================================
+FunctionJobXp::FunctionJobXp(void *(*function)(void *), void *arg /*= NULL*/)
+{
+ d_function = function;
+ d_arg = arg;
+ d_result = NULL;
+}
+
+
+//==============================================================================
+// FunctionJobXp::get
+//==============================================================================
+void *FunctionJobXp::get()
+{
+ wait();
+ return d_result;
+}
+
+
+//==============================================================================
+// FunctionJobXp::execute
+//==============================================================================
+void FunctionJobXp::execute()
+{
+ d_result = d_function(d_arg);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::ThreadPoolXp
+//==============================================================================
+ThreadPoolXp::ThreadPoolXp(int numWorkers /*= 0*/,
+                           int policy /*= SCHED_OTHER*/,
+                           int sched_priority /*= 0*/,
+                           size_t stacksize /*= THREAD_POOL_STACK*/,
+                           int queueSize /*= THREAD_POOL_QUEUE*/)
+{
+ uint32_t size = 1;
+ void *memory;
+ int created = 0;
+ int started = 0;
+ int code;
+
+ if(numWorkers <= 0)
+  numWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+ if(numWorkers <= 0)
+  numWorkers = 1;
+ while(size < (uint32_t)queueSize)
+  size <<= 1;
+
+ d_numWorkers = numWorkers;
+ d_queueMask = size - 1;
+ d_next = 0;
+ d_pending = 0;
+ d_stopping = 0;
+ d_stopped = false;
+
+ // new[] does not honour the 64 byte alignment in C++98, and a queue
+ // sharing a cache line with its neighbour would bounce between workers
+ if(posix_memalign(&memory, sizeof(Queue), numWorkers * sizeof(Queue)) != 0)
+  throw ZnmException("ThreadPoolXp", "posix_memalign", ENOMEM);
+ d_queues = (Queue *)memory;
+ for(int i = 0; i < numWorkers; i++)
+ {
+  new (&d_queues[i]) Queue;
+  d_queues[i].jobs = NULL;
+  d_queues[i].top = 0;
+  d_queues[i].bottom = 0;
+ }
+ d_workers = NULL;
+
+ try
+ {
+  for(int i = 0; i < numWorkers; i++)
+   d_queues[i].jobs = new JobXp *[size];
+
+  d_workers = new Worker *[numWorkers];
+  for(; created < numWorkers; created++)
+   d_workers[created] = new Worker(this, created, policy, sched_priority, stacksize);
+  for(; started < numWorkers; started++)
+  {
+   code = d_workers[started]->run();
+   if(code != 0)
+    throw ZnmException("ThreadPoolXp", "run", code);
+  }
+ }
+ catch(...)
+ {
+  // The destructor does not run, stop the workers that did start
+  __atomic_store_n(&d_stopping, 1, __ATOMIC_SEQ_CST);
+  d_idle.notifyAll();
+  for(int i = 0; i < started; i++)
+   d_workers[i]->join();
+  release(created);
+  throw;
+ }
+}
+
+
+//==============================================================================
+// ThreadPoolXp::~ThreadPoolXp
+//==============================================================================
+ThreadPoolXp::~ThreadPoolXp()
+{
+ shutdown();
+ release(d_numWorkers);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::release
+//==============================================================================
+void ThreadPoolXp::release(int workers)
+{
+ for(int i = 0; i < workers; i++)
+  delete d_workers[i];
+ delete [] d_workers;
+
+ for(int i = 0; i < d_numWorkers; i++)
+ {
+  delete [] d_queues[i].jobs;
+  d_queues[i].~Queue();
+ }
+ free(d_queues);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::submit
+//==============================================================================
+void ThreadPoolXp::submit(JobXp *job)
+{
+ int first;
+
+ if(__atomic_load_n(&d_stopping, __ATOMIC_RELAXED) && t_pool != this)
+  throw(ZnmException("ThreadPoolXp", "submit", EPERM));
+
+ if(t_pool == this)
+  first = t_worker;
+ else
+  first = __atomic_fetch_add(&d_next, 1, __ATOMIC_RELAXED) % d_numWorkers;
+
+ job->d_failed = false;
+ __atomic_store_n(&job->d_state, JOB_PENDING, __ATOMIC_RELAXED);
+
+ // Counted before it is visible, so d_pending never goes negative
+ __atomic_add_fetch(&d_pending, 1, __ATOMIC_SEQ_CST);
+ for(int i = 0; i < d_numWorkers; i++)
+ {
+  if(push((first + i) % d_numWorkers, job))
+  {
+   d_idle.notify();
+   return;
+  }
+ }
+ __atomic_sub_fetch(&d_pending, 1, __ATOMIC_SEQ_CST);
+
+ // All queues are full
+ runJob(job);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::shutdown
+//==============================================================================
+void ThreadPoolXp::shutdown()
+{
+ if(d_stopped)
+  return;
+ d_stopped = true;
+
+ __atomic_store_n(&d_stopping, 1, __ATOMIC_SEQ_CST);
+ d_idle.notifyAll();
+
+ for(int i = 0; i < d_numWorkers; i++)
+  d_workers[i]->join();
+}
+
+
+//==============================================================================
+// ThreadPoolXp::getWorkerCount
+//==============================================================================
+int ThreadPoolXp::getWorkerCount() const
+{
+ return d_numWorkers;
+}
+
+
+//==============================================================================
+// ThreadPoolXp::setWorkerAffinity
+//==============================================================================
+int ThreadPoolXp::setWorkerAffinity(int worker, const cpu_set_t *cpuMask)
+{
+ if(worker < 0 || worker >= d_numWorkers)
+  return EINVAL;
+ return d_workers[worker]->setAffinity(cpuMask);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::setWorkerPriority
+//==============================================================================
+int ThreadPoolXp::setWorkerPriority(int worker, int policy, int sched_priority)
+{
+ if(worker < 0 || worker >= d_numWorkers)
+  return EINVAL;
+ return d_workers[worker]->setPriority(policy, sched_priority);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::push
+//==============================================================================
+bool ThreadPoolXp::push(int queue, JobXp *job)
+{
+ Queue *q = &d_queues[queue];
+ bool pushed = false;
+
+ q->lock.lock();
+ if(q->bottom - q->top <= d_queueMask)
+ {
+  q->jobs[q->bottom & d_queueMask] = job;
+  q->bottom++;
+  pushed = true;
+ }
+ q->lock.unlock();
+ return pushed;
+}
+
+
+//==============================================================================
+// ThreadPoolXp::take
+//==============================================================================
+JobXp *ThreadPoolXp::take(int self)
+{
+ JobXp *job = NULL;
+ Queue *q;
+ int start;
+
+ if(__atomic_load_n(&d_pending, __ATOMIC_ACQUIRE) <= 0)
+  return NULL;
+
+ if(self >= 0)
+ {
+  q = &d_queues[self];
+  q->lock.lock();
+  if(q->bottom != q->top)
+   job = q->jobs[--q->bottom & d_queueMask];
+  q->lock.unlock();
+ }
+
+ start = (self >= 0) ? self + 1 : 0;
+ for(int i = 0; job == NULL && i < d_numWorkers; i++)
+ {
+  q = &d_queues[(start + i) % d_numWorkers];
+  // Peek without the lock, most queues are empty when stealing
+  if(__atomic_load_n(&q->bottom, __ATOMIC_RELAXED) ==
+     __atomic_load_n(&q->top, __ATOMIC_RELAXED))
+   continue;
+  q->lock.lock();
+  if(q->bottom != q->top)
+   job = q->jobs[q->top++ & d_queueMask];
+  q->lock.unlock();
+ }
+
+ if(job != NULL)
+  __atomic_sub_fetch(&d_pending, 1, __ATOMIC_SEQ_CST);
+ return job;
+}
+
+
+//==============================================================================
+// ThreadPoolXp::runOne
+//==============================================================================
+bool ThreadPoolXp::runOne(int self)
+{
+ JobXp *job = take(self);
+
+ if(job == NULL)
+  return false;
+ runJob(job);
+ return true;
+}
+
+
+//==============================================================================
+// ThreadPoolXp::runJob
+//==============================================================================
+void ThreadPoolXp::runJob(JobXp *job)
+{
+ try
+ {
+  job->execute();
+ }
+ catch(...)
+ {
+  job->complete(true);
+  return;
+ }
+ job->complete(false);
+}
+
+
+//==============================================================================
+// ThreadPoolXp::helpUntilDone
+//==============================================================================
+void ThreadPoolXp::helpUntilDone(JobXp *job)
+{
+ if(t_pool == NULL)
+  return;
+
+ while(!job->isDone() && t_pool->runOne(t_worker))
+  ;
+}
+
+
+//==============================================================================
+// ThreadPoolXp::workerLoop
+//==============================================================================
+void ThreadPoolXp::workerLoop(int self)
+{
+ uint32_t key;
+
+ for(;;)
+ {
+  if(runOne(self))
+   continue;
+
+  key = d_idle.prepareWait();
+  if(__atomic_load_n(&d_pending, __ATOMIC_SEQ_CST) > 0)
+  {
+   d_idle.cancelWait();
+   continue;
+  }
+  if(__atomic_load_n(&d_stopping, __ATOMIC_SEQ_CST))
+  {
+   d_idle.cancelWait();
+   break;
+  }
+  d_idle.commitWait(key);
+ }
+}
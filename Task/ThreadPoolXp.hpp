@@ -0,0 +1,221 @@
+//==============================================================================
+// ThreadPoolXp.hpp - Work stealing thread pool.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _THREADPOOLXP_HPP_INCLUDED
+#define _THREADPOOLXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+#include "ThreadXp.hpp"
+#include "FutexMutexXp.hpp"
+#include "EventCountXp.hpp"
+
+#define THREAD_POOL_QUEUE 256          // Default jobs per worker queue
+#define THREAD_POOL_STACK (256 * 1024) // Default worker stack size
+
+class ThreadPoolXp;
+
+//==============================================================================
+// class JobXp
+//------------------------------------------------------------------------------
+// \brief
+// A unit of work for ThreadPoolXp, and the handle to wait for it.
+//
+// Derive from JobXp, put the inputs and results in the derived class and
+// override execute(). After ThreadPoolXp::submit(), wait() returns once
+// execute() has run; the results can then be read from the object. The
+// job is thereby its own future; FunctionJobXp::get() is the future of a
+// plain function.
+//
+// <ul>
+// <li>The pool does not own jobs. A job must stay valid until wait()
+//     has returned (or isDone() is true).
+// <li>A job can be submitted again once it is done.
+// </ul>
+//==============================================================================
+
+class JobXp
+{
+ friend class ThreadPoolXp;
+ public:
+  JobXp();
+   // Constructs a job that is done (not submitted).
+
+  virtual ~JobXp();
+
+  void wait();
+   // Blocks until the job has been executed. Called from a worker
+   // of the pool, runs other queued jobs while waiting, so jobs may
+   // wait for jobs they submitted.
+
+  bool isDone();
+   //  return  true if the job has been executed.
+
+  bool failed();
+   //  return  true if execute() ended with an exception.
+
+ protected:
+  virtual void execute() = 0;
+   // The work. Runs in a worker thread, or in the thread calling
+   // submit() if all queues are full.
+
+ private:
+  void complete(bool failed);
+
+  uint32_t d_state;
+   // JOB_PENDING, JOB_DONE or JOB_WAITING (pending, with sleepers)
+
+  bool d_failed;
+};
+
+
+//==============================================================================
+// class FunctionJobXp
+//------------------------------------------------------------------------------
+// \brief
+// A JobXp calling a plain function, for work that needs no class.
+//==============================================================================
+
+class FunctionJobXp : public JobXp
+{
+ public:
+  FunctionJobXp(void *(*function)(void *), void *arg = NULL);
+
+  void *get();
+   // Waits for the job.
+   //  return  return value of the function.
+
+ protected:
+  virtual void execute();
+
+ private:
+  void *(*d_function)(void *);
+  void *d_arg;
+  void *d_result;
+};
+
+
+//==============================================================================
+// class ThreadPoolXp
+//------------------------------------------------------------------------------
+// \brief
+// Runs short jobs (decoding, filtering and so on) on a fixed set of
+// worker threads instead of a thread per job.
+//
+// <ul>
+// <li>Every worker has its own queue. A job submitted from a worker goes
+//     to that worker's queue and is run last in first out, while its
+//     data is still in cache; other jobs are spread round robin.
+// <li>An idle worker steals the oldest job from the other queues, so
+//     work spreads across cores without a central queue.
+// <li>Idle workers sleep on an eventcount; submit() makes a system call
+//     only if some worker sleeps.
+// <li>If all queues are full, submit() runs the job in the calling thread.
+// <li>Workers are ThreadXp threads: policy, priority and affinity can be
+//     set per worker.
+// <li>This class will throw an exception of type ZnmException in case of
+//     errors.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  class Decode : public JobXp { ... void execute() { ... } };
+//
+//  ThreadPoolXp pool(4);
+//  Decode jobs[16];
+//  for(int i = 0; i < 16; i++)
+//   pool.submit(&jobs[i]);
+//  for(int i = 0; i < 16; i++)
+//   jobs[i].wait();
+// </pre>
+//==============================================================================
+
+class ThreadPoolXp
+{
+ friend class JobXp;
+ public:
+  ThreadPoolXp(int numWorkers = 0,
+               int policy = SCHED_OTHER,
+               int sched_priority = 0,
+               size_t stacksize = THREAD_POOL_STACK,
+               int queueSize = THREAD_POOL_QUEUE);
+   // Starts the workers.
+   //  numWorkers  Number of worker threads, 0 for one per online CPU.
+   //  queueSize   Jobs per worker queue, rounded up to a power of 2.
+
+  ~ThreadPoolXp();
+   // Calls shutdown().
+
+  void submit(JobXp *job);
+   // Queues the job for execution. Throws ZnmException with EPERM
+   // after shutdown().
+
+  void shutdown();
+   // Runs the jobs still queued, then stops and joins the workers.
+
+  int getWorkerCount() const;
+
+  int setWorkerAffinity(int worker, const cpu_set_t *cpuMask);
+   //  return  0 on success, and errno code on error.
+
+  int setWorkerPriority(int worker, int policy, int sched_priority);
+   //  return  0 on success, and errno code on error.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  class Worker;
+
+  struct Queue
+  {
+   FutexMutexXp lock;
+   JobXp **jobs;
+   uint32_t top;
+    // Oldest job, stolen by other workers
+   uint32_t bottom;
+    // Newest job, taken by the owner
+  } __attribute__((aligned(64)));
+
+  bool push(int queue, JobXp *job);
+
+  JobXp *take(int self);
+   // Own queue first (newest job), then steal (oldest job).
+   // self is -1 for threads that are not workers of this pool.
+
+  bool runOne(int self);
+
+  static void runJob(JobXp *job);
+
+  static void helpUntilDone(JobXp *job);
+   // Runs other jobs while job is pending, if called by a worker
+
+  void workerLoop(int self);
+
+  void release(int workers);
+   // Deletes the first workers (already joined) and the queues
+
+  Queue *d_queues;
+  Worker **d_workers;
+  int d_numWorkers;
+  uint32_t d_queueMask;
+
+  uint32_t d_next;
+   // Round robin queue for jobs from other threads
+
+  int d_pending;
+   // Jobs queued and not yet taken
+
+  int d_stopping;
+  bool d_stopped;
+
+  EventCountXp d_idle;
+   // Idle workers sleep here
+};
+
+#endif // _THREADPOOLXP_HPP_INCLUDED
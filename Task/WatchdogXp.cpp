@@ -0,0 +1,309 @@
+//==============================================================================
+// WatchdogXp.cpp - Detection of stalled tasks by heartbeat deadlines.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "WatchdogXp.hpp"
+#include "znmException.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#define ENTRY_FREE 0
+#define ENTRY_SETUP 1
+#define ENTRY_ACTIVE 2
+
+#define ENTRY_STATE_MASK 3
+#define ENTRY_GENERATIONS (INT_MAX / WATCHDOG_MAX_ENTRIES)
+ // An id is generation * WATCHDOG_MAX_ENTRIES + index
+
+//==============================================================================
+// class WatchdogXp::Monitor
+//==============================================================================
+class WatchdogXp::Monitor : public ThreadXp
+{
+ public:
+  Monitor(WatchdogXp *watchdog, int timerFd, int policy, int sched_priority,
+          const cpu_set_t *cpuMask)
+   : ThreadXp(PTHREAD_CREATE_JOINABLE, PTHREAD_STACK_MIN, PTHREAD_EXPLICIT_SCHED,
+              policy, sched_priority, "watchdog", 1, cpuMask),
+     d_watchdog(watchdog), d_timerFd(timerFd), d_stop(0) {}
+
+  ~Monitor()
+  {
+   close(d_timerFd);
+  }
+
+  void stop()
+  {
+   __atomic_store_n(&d_stop, 1, __ATOMIC_RELEASE);
+  }
+
+ protected:
+  virtual void enterThread(void * /*arg*/) {}
+
+  virtual int executeInThread(void * /*arg*/)
+  {
+   uint64_t expirations;
+
+   while(!__atomic_load_n(&d_stop, __ATOMIC_ACQUIRE))
+   {
+    if(read(d_timerFd, &expirations, sizeof(expirations)) < 0 && errno != EINTR)
+     return errno;
+    d_watchdog->check();
+   }
+   return 0;
+  }
+
+  virtual void exitThread(void * /*arg*/) {}
+
+ private:
+  WatchdogXp *d_watchdog;
+  int d_timerFd;
+  int d_stop;
+};
+
+
+//==============================================================================
+// WatchdogXp::WatchdogXp
+//==============================================================================
+WatchdogXp::WatchdogXp(const TimeoutXp &checkPeriod,
+                       WatchdogHandlerXp *handler /*= NULL*/)
+{
+ if(checkPeriod.getNanoseconds() <= 0)
+  throw ZnmException("WatchdogXp", "checkPeriod", EINVAL);
+
+ memset(d_entries, 0, sizeof(d_entries));
+ d_checkPeriod = checkPeriod.getNanoseconds();
+ d_handler = handler;
+ d_monitor = NULL;
+}
+
+
+//==============================================================================
+// WatchdogXp::~WatchdogXp
+//==============================================================================
+WatchdogXp::~WatchdogXp()
+{
+ stop();
+}
+
+
+//==============================================================================
+// WatchdogXp::start
+//==============================================================================
+int WatchdogXp::start(int policy /*= SCHED_OTHER*/, int sched_priority /*= 0*/,
+                      const cpu_set_t *cpuMask /*= NULL*/)
+{
+ struct itimerspec its;
+ int fd, code;
+
+ if(d_monitor != NULL)
+  return EBUSY;
+
+ fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+ if(fd < 0)
+  return errno;
+ its.it_interval.tv_sec = d_checkPeriod / DEADLINE_NSEC_PER_SEC;
+ its.it_interval.tv_nsec = d_checkPeriod % DEADLINE_NSEC_PER_SEC;
+ its.it_value = its.it_interval;
+ if(timerfd_settime(fd, 0, &its, NULL) != 0)
+ {
+  code = errno;
+  close(fd);
+  return code;
+ }
+
+ // The monitor owns the descriptor from here on
+ d_monitor = new Monitor(this, fd, policy, sched_priority, cpuMask);
+ code = d_monitor->run();
+ if(code != 0)
+ {
+  delete d_monitor;
+  d_monitor = NULL;
+ }
+ return code;
+}
+
+
+//==============================================================================
+// WatchdogXp::stop
+//==============================================================================
+void WatchdogXp::stop()
+{
+ if(d_monitor == NULL)
+  return;
+
+ d_monitor->stop();
+ d_monitor->join();
+ delete d_monitor;
+ d_monitor = NULL;
+}
+
+
+//==============================================================================
+// WatchdogXp::add
+//==============================================================================
+int WatchdogXp::add(const char *name, const TimeoutXp &timeout,
+                    int actions /*= WATCHDOG_REPORT*/)
+{
+ uint32_t state, generation;
+ Entry *e;
+
+ if(timeout.getNanoseconds() <= 0)
+  throw ZnmException("WatchdogXp", "add", EINVAL);
+
+ for(int i = 0; i < WATCHDOG_MAX_ENTRIES; i++)
+ {
+  e = &d_entries[i];
+  state = __atomic_load_n(&e->state, __ATOMIC_RELAXED);
+  if((state & ENTRY_STATE_MASK) != ENTRY_FREE)
+   continue;
+  // Generation 0 is never used, so no id is 0 .. WATCHDOG_MAX_ENTRIES-1
+  generation = (state >> 2) % (ENTRY_GENERATIONS - 1) + 1;
+  if(!__atomic_compare_exchange_n(&e->state, &state, generation << 2 | ENTRY_SETUP,
+                                  false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+   continue;
+
+  e->timeout = timeout.getNanoseconds();
+  e->lastKick = DeadlineXp::now().getNanoseconds();
+  e->actions = actions;
+  e->name[0] = '\0';
+  if(name != NULL)
+   strncat(e->name, name, THREAD_NAME_LEN - 1);
+
+  // The monitor looks only at active entries
+  __atomic_store_n(&e->state, generation << 2 | ENTRY_ACTIVE, __ATOMIC_RELEASE);
+  return generation * WATCHDOG_MAX_ENTRIES + i;
+ }
+ return -1;
+}
+
+
+//==============================================================================
+// WatchdogXp::remove
+//==============================================================================
+void WatchdogXp::remove(int id)
+{
+ uint32_t state;
+ Entry *e = find(id, &state);
+
+ if(e != NULL)
+  __atomic_compare_exchange_n(&e->state, &state, state & ~ENTRY_STATE_MASK,
+                              false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// WatchdogXp::kick
+//==============================================================================
+void WatchdogXp::kick(int id)
+{
+ uint32_t state;
+ Entry *e = find(id, &state);
+
+ // A kick racing with remove() and add() can still land on the new
+ // task, but only once and with about the time add() set
+ if(e != NULL && __atomic_load_n(&e->state, __ATOMIC_ACQUIRE) == state)
+  __atomic_store_n(&e->lastKick, DeadlineXp::now().getNanoseconds(),
+                   __ATOMIC_RELEASE);
+}
+
+
+//==============================================================================
+// WatchdogXp::getMisses
+//==============================================================================
+uint64_t WatchdogXp::getMisses(int id)
+{
+ uint32_t state;
+ uint64_t misses;
+ Entry *e = find(id, &state);
+
+ if(e == NULL || __atomic_load_n(&e->seen, __ATOMIC_ACQUIRE) != state)
+  return 0;
+ misses = __atomic_load_n(&e->misses, __ATOMIC_RELAXED);
+ // Not reset for a later task in the meantime
+ __atomic_thread_fence(__ATOMIC_ACQUIRE);
+ if(__atomic_load_n(&e->seen, __ATOMIC_RELAXED) != state)
+  return 0;
+ return misses;
+}
+
+
+//==============================================================================
+// WatchdogXp::find
+//==============================================================================
+WatchdogXp::Entry *WatchdogXp::find(int id, uint32_t *state)
+{
+ if(id < WATCHDOG_MAX_ENTRIES)
+  return NULL;
+ *state = (uint32_t)(id / WATCHDOG_MAX_ENTRIES) << 2 | ENTRY_ACTIVE;
+ return &d_entries[id % WATCHDOG_MAX_ENTRIES];
+}
+
+
+//==============================================================================
+// WatchdogXp::check
+//==============================================================================
+void WatchdogXp::check()
+{
+ int64_t now = DeadlineXp::now().getNanoseconds();
+ int64_t kick, timeout;
+ uint32_t state;
+ Entry copy;
+ Entry *e;
+
+ for(int i = 0; i < WATCHDOG_MAX_ENTRIES; i++)
+ {
+  e = &d_entries[i];
+  state = __atomic_load_n(&e->state, __ATOMIC_ACQUIRE);
+  if((state & ENTRY_STATE_MASK) != ENTRY_ACTIVE)
+   continue;
+
+  // add() may set up the entry again while we read it
+  kick = __atomic_load_n(&e->lastKick, __ATOMIC_ACQUIRE);
+  timeout = e->timeout;
+  copy.actions = e->actions;
+  memcpy(copy.name, e->name, sizeof(copy.name));
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+  if(__atomic_load_n(&e->state, __ATOMIC_RELAXED) != state)
+   continue;
+
+  if(e->seen != state)
+  {
+   // First look at this task
+   e->reported = -1;
+   __atomic_store_n(&e->misses, 0, __ATOMIC_RELAXED);
+   __atomic_store_n(&e->seen, state, __ATOMIC_RELEASE);
+  }
+
+  // Once per deadline, not once per check
+  if(now - kick > timeout && kick != e->reported)
+  {
+   e->reported = kick;
+   __atomic_store_n(&e->misses, e->misses + 1, __ATOMIC_RELAXED);
+   missed((state >> 2) * WATCHDOG_MAX_ENTRIES + i, &copy, now - kick - timeout);
+  }
+ }
+}
+
+
+//==============================================================================
+// WatchdogXp::missed
+//==============================================================================
+void WatchdogXp::missed(int id, Entry *e, int64_t late)
+{
+ if(e->actions & WATCHDOG_REPORT)
+  fprintf(stderr, "WatchdogXp: task %d (%s) missed its deadline by %lld us\n",
+          id, e->name, (long long)(late / 1000));
+ if(d_handler != NULL)
+  d_handler->missed(id, e->name, TimeoutXp(late));
+ if(e->actions & WATCHDOG_ABORT)
+  abort();
+}
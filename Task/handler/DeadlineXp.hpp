@@ -0,0 +1,141 @@
+//==============================================================================
+// DeadlineXp.hpp - Relative timeouts and monotonic deadlines.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _DEADLINEXP_HPP_INCLUDED
+#define _DEADLINEXP_HPP_INCLUDED
+
+#include <time.h>
+#include <inttypes.h>
+
+#define DEADLINE_NSEC_PER_SEC 1000000000LL
+
+//==============================================================================
+// class TimeoutXp
+//------------------------------------------------------------------------------
+// \brief
+// A relative timeout, e.g. TimeoutXp::milliseconds(5).
+//
+// <ul>
+// <li>Every blocking call that takes a DeadlineXp also takes a TimeoutXp,
+//     which is turned into a deadline when the call is made.
+// <li>Negative timeouts are treated as zero (the deadline has passed).
+// </ul>
+//==============================================================================
+
+class TimeoutXp
+{
+ public:
+  explicit TimeoutXp(int64_t ns = 0) : d_ns(ns < 0 ? 0 : ns) {}
+   // Constructs a timeout of ns nanoseconds
+
+  static TimeoutXp seconds(int64_t s) { return TimeoutXp(s * DEADLINE_NSEC_PER_SEC); }
+  static TimeoutXp milliseconds(int64_t ms) { return TimeoutXp(ms * 1000000LL); }
+  static TimeoutXp microseconds(int64_t us) { return TimeoutXp(us * 1000LL); }
+  static TimeoutXp nanoseconds(int64_t ns) { return TimeoutXp(ns); }
+
+  int64_t getNanoseconds() const { return d_ns; }
+
+  //======== END OF INTERFACE ========
+
+ private:
+  int64_t d_ns;
+};
+
+
+//==============================================================================
+// class DeadlineXp
+//------------------------------------------------------------------------------
+// \brief
+// An absolute point in time on CLOCK_MONOTONIC.
+//
+// <ul>
+// <li>Unlike CLOCK_REALTIME, CLOCK_MONOTONIC is not stepped by NTP or
+//     settimeofday(), so a deadline is not stretched or cut short by a
+//     clock change.
+// <li>A deadline can be computed once and passed to several blocking
+//     calls in a row (e.g. lock a mutex, then wait on a condition
+//     variable) so the total wait is bounded.
+// <li>Interfaces that only take a CLOCK_REALTIME time (mq_timedsend(),
+//     pthread_mutex_timedlock() on old C libraries) get the deadline
+//     converted when the call is made; a clock step during such a wait
+//     still affects it.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  DeadlineXp deadline(TimeoutXp::milliseconds(20));
+//  if(mutex.timedLock(deadline) == 0)
+//  {
+//   while(!ready && cond.condTimedWait(&mutex, deadline) == 0)
+//    ;
+//   mutex.unlock();
+//  }
+// </pre>
+//==============================================================================
+
+class DeadlineXp
+{
+ public:
+  DeadlineXp(const TimeoutXp &timeout) : d_ns(nowNs() + timeout.getNanoseconds()) {}
+   // Deadline 'timeout' from now. Not explicit, so a TimeoutXp can be
+   // passed wherever a DeadlineXp is expected.
+
+  explicit DeadlineXp(const struct timespec &monotonic)
+   : d_ns((int64_t)monotonic.tv_sec * DEADLINE_NSEC_PER_SEC + monotonic.tv_nsec) {}
+   // Deadline at an absolute CLOCK_MONOTONIC time
+
+  static DeadlineXp now() { return DeadlineXp(TimeoutXp(0)); }
+
+  bool expired() const { return nowNs() >= d_ns; }
+
+  TimeoutXp remaining() const { return TimeoutXp(d_ns - nowNs()); }
+   // Time left, zero if the deadline has passed
+
+  inline void toTimespec(clockid_t clk_id, struct timespec *ts) const;
+   // The deadline as an absolute time on clk_id. For clocks other than
+   // CLOCK_MONOTONIC the remaining time is added to the current time of
+   // clk_id.
+
+  int64_t getNanoseconds() const { return d_ns; }
+   // CLOCK_MONOTONIC time in nanoseconds
+
+  //======== END OF INTERFACE ========
+
+ private:
+  static inline int64_t nowNs(clockid_t clk_id = CLOCK_MONOTONIC);
+
+  int64_t d_ns;
+};
+
+
+//==============================================================================
+// DeadlineXp::toTimespec(clockid_t clk_id, struct timespec *ts)
+//==============================================================================
+void DeadlineXp::toTimespec(clockid_t clk_id, struct timespec *ts) const
+{
+ int64_t ns = d_ns;
+
+ if(clk_id != CLOCK_MONOTONIC)
+  ns = nowNs(clk_id) + remaining().getNanoseconds();
+
+ ts->tv_sec = ns / DEADLINE_NSEC_PER_SEC;
+ ts->tv_nsec = ns % DEADLINE_NSEC_PER_SEC;
+}
+
+
+//==============================================================================
+// DeadlineXp::nowNs(clockid_t clk_id)
+//==============================================================================
+int64_t DeadlineXp::nowNs(clockid_t clk_id /*= CLOCK_MONOTONIC*/)
+{
+ struct timespec ts;
+ clock_gettime(clk_id, &ts);
+ return (int64_t)ts.tv_sec * DEADLINE_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+#endif // _DEADLINEXP_HPP_INCLUDED
@@ -14,23 +14,24 @@
 
 #include <cstring>
 #include "ThreadXp.hpp"
+#include "PeriodicThreadXp.hpp"
 #include "MutexXp.hpp"
 #include "CondVariableXp.hpp"
-#include "ShMemXp.hpp"
+#include "ShMemCatalogXp.hpp"
+#include "ShMemSyncXp.hpp"
 #include "MessageQueueXp.hpp"
 
 #define BUFFER_SIZE 20
 #define M_QUEUE "/mal7"
+#define SHM_NAME "/HandlerShm"
+#define SHM_SIZE 4096
 
 using namespace std;
 
-MutexXp mutex;
-CondVariableXp condVar;
-
 class HandlerTask : public ThreadXp
 {
 public:
-	HandlerTask();
+	HandlerTask(ShMemCatalogXp* shm, ShMemSyncXp* sync);
   	~HandlerTask();
 
 protected:
@@ -39,26 +40,26 @@ protected:
  	virtual void exitThread(void *arg);
 
 private:
-	ShMemXp shmNumOfElem;
-	ShMemXp shmBuffer;
+	MutexXp* _mutex;
+	CondVariableXp* _condVar;
   	MessageQueueXp _mq1;
 
 	int* _numOfElem;
 	int* _buffer;
 };
 
-class ConsumerTask : public ThreadXp
+class ConsumerTask : public PeriodicThreadXp
 {
 public:
-  	ConsumerTask();
+  	ConsumerTask(ShMemCatalogXp* shm, ShMemSyncXp* sync);
     ~ConsumerTask();
 protected:
 	virtual void enterThread(void *arg);
-	virtual int executeInThread(void *arg);
+	virtual int executeCycle(void *arg);
 	virtual void exitThread(void *arg);
 private:
-	ShMemXp shmNumOfElem;
-	ShMemXp shmBuffer;
+	MutexXp* _mutex;
+	CondVariableXp* _condVar;
 
 	int* _numOfElem;
 	int* _buffer;
@@ -66,8 +67,12 @@ private:
 };
 
 int main(void) {
-	HandlerTask MyHandler;
-	ConsumerTask MyConsumer;
+	// One mapping of the segment for both tasks
+	ShMemCatalogXp shm(SHM_NAME, SHM_SIZE);
+	ShMemSyncXp sync(&shm);
+
+	HandlerTask MyHandler(&shm, &sync);
+	ConsumerTask MyConsumer(&shm, &sync);
 
 	MyHandler.run(&MyHandler);
 	MyConsumer.run(&MyConsumer);
@@ -75,17 +80,21 @@ int main(void) {
 	MyHandler.join();
 	MyConsumer.join();
 
+	shm.unlink();
+
 	return 0;
 }
 
-HandlerTask::HandlerTask() : 
-			shmNumOfElem("/NumOfElemShm", sizeof(int)), 
-			shmBuffer("/BufferShm", sizeof(int) * BUFFER_SIZE),
+HandlerTask::HandlerTask(ShMemCatalogXp* shm, ShMemSyncXp* sync) : 
 			_mq1(M_QUEUE){
 
-	_numOfElem = (int*) shmNumOfElem.getShmAddr();
+	_numOfElem = (int*) shm->create("NumOfElem", sizeof(int));
+
+	_buffer = (int*) shm->create("Buffer", sizeof(int) * BUFFER_SIZE);
 
-	_buffer = (int*) shmBuffer.getShmAddr();
+	_mutex = sync->mutex("Mutex");
+
+	_condVar = sync->condVariable("CondVar");
 
 
 
@@ -112,18 +121,26 @@ int HandlerTask::executeInThread(void *arg){
 
 	while(1){
 		
-		_mq1.receive(msg_buffer, 512);
+		// -1 once requestStop() was called
+		if(_mq1.receive(msg_buffer, 512, getStopToken()) == -1)
+			break;
 
 		msg = (int)(msg_buffer[0] - '0');
 
 		cerr << "aldım ulan: " << msg << endl;
 
-		mutex.lock();
-		while(*_numOfElem == BUFFER_SIZE)
-			condVar.condWait(&mutex);
+		_mutex->lock();
+		while(*_numOfElem == BUFFER_SIZE){
+			if(_condVar->condWait(_mutex, getStopToken()) == -1)
+				break;
+		}
+		if(stopRequested()){
+			_mutex->unlock();
+			break;
+		}
 		_buffer[(*_numOfElem)++] = msg;
-		condVar.condSignal();
-		mutex.unlock();
+		_condVar->condSignal();
+		_mutex->unlock();
 		nanosleep(&delay, NULL);
 	}
 
@@ -131,18 +148,18 @@ int HandlerTask::executeInThread(void *arg){
 }
 
 void HandlerTask::exitThread(void *arg){ 
-	shmNumOfElem.unlink();
-	shmBuffer.unlink();
-
 	cerr << "exit h" << endl << flush;
 }
-ConsumerTask::ConsumerTask() : 
-			shmNumOfElem("/NumOfElemShm", sizeof(int)), 
-			shmBuffer("/BufferShm", sizeof(int) * BUFFER_SIZE){
+ConsumerTask::ConsumerTask(ShMemCatalogXp* shm, ShMemSyncXp* sync) : 
+			PeriodicThreadXp(TimeoutXp::milliseconds(300)){
+
+	_numOfElem = (int*) shm->create("NumOfElem", sizeof(int));
+
+	_buffer = (int*) shm->create("Buffer", sizeof(int) * BUFFER_SIZE);
 
-	_numOfElem = (int*) shmNumOfElem.getShmAddr();
+	_mutex = sync->mutex("Mutex");
 
-	_buffer = (int*) shmBuffer.getShmAddr();
+	_condVar = sync->condVariable("CondVar");
 }
 
 ConsumerTask::~ConsumerTask(){ }
@@ -152,32 +169,20 @@ void ConsumerTask::enterThread(void *arg){
 	cerr << "enter c" << endl << flush;
 }
 
-int ConsumerTask::executeInThread(void *arg){
+int ConsumerTask::executeCycle(void *arg){
 	int msg;
-	struct timespec delay;
-
- 	delay.tv_sec = 0;
- 	delay.tv_nsec = (long int)3e8;
-
- 	cerr << "execute c" << endl << flush;
 
-	while(1){
-		mutex.lock();
-		while(*_numOfElem == 0)
-			condVar.condWait(&mutex);
-		msg = _buffer[--(*_numOfElem)];
-		cerr << "message: " << msg << endl;
-		condVar.condSignal();
-		mutex.unlock();
-		nanosleep(&delay, NULL);
-	}
+	_mutex->lock();
+	while(*_numOfElem == 0)
+		_condVar->condWait(_mutex);
+	msg = _buffer[--(*_numOfElem)];
+	cerr << "message: " << msg << endl;
+	_condVar->condSignal();
+	_mutex->unlock();
 
 	return 0;
 }
 
 void ConsumerTask::exitThread(void *arg){ 
-	shmNumOfElem.unlink();
-	shmBuffer.unlink();
-
 	cerr << "exit c" << endl << flush;
 }
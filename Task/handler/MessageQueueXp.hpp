@@ -6,7 +6,11 @@
 // Modification History:
 // Date         Version        Modified By			Description
 // 22.10.2015   1.0            Said Nuri UYANIK     Initial creation
-// 
+// 19.10.2026   1.1                                 DeadlineXp timeouts for send/receive
+// 19.10.2026   1.2                                 getDescriptor() for polling
+// 19.10.2026   1.3                                 receive() with a StopTokenXp
+// 19.10.2026   1.4                                 getDescriptor() throws under Xenomai
+// 19.10.2026   1.5                                 receive() with a StopTokenXp keeps the blocking mode
 //==============================================================================
 
 #ifndef _MESSAGEQUEUE_HPP_INCLUDED
@@ -17,6 +21,8 @@
 #include <errno.h>
 #include <pthread.h>
 #include <stdio.h>
+#include "DeadlineXp.hpp"
+#include "StopTokenXp.hpp"
 
 #define MAXNUMMSG 128  //DefaULT maximum number of message in queue
 #define MAXMSGLEN 128 //Default maximum message length
@@ -56,10 +62,30 @@ public:
 
 	int send(const char *msg_buf, int msg_size, const struct timespec * timeout = NULL);
 
+	/** 
+	 * Like send() with an absolute CLOCK_REALTIME timeout, but takes a
+	 * CLOCK_MONOTONIC deadline or a TimeoutXp. mq_timedsend() only
+	 * knows CLOCK_REALTIME, so the deadline is converted on the call.
+	 =================================================*/
+	int send(const char *msg_buf, int msg_size, const DeadlineXp& deadline);
+
 	int try_send(const char *msg_buf, int msg_size);
 
 	int receive(char *msg_buf, int buf_size, const struct timespec * timeout = NULL);
 
+	/** 
+	 * Like receive(), see send() with a DeadlineXp.
+	 =================================================*/
+	int receive(char *msg_buf, int buf_size, const DeadlineXp& deadline);
+
+	/** 
+	 * Like receive(), but returns -1 with ECANCELED in getErrno() once a
+	 * stop is requested on token. Polls the queue and the token
+	 * descriptor, so it works only where getDescriptor() can be polled.
+	 * The queue is back in its previous blocking mode on return.
+	 =================================================*/
+	int receive(char *msg_buf, int buf_size, StopTokenXp& token);
+
 	int try_receive(char *msg_buf, int buf_size);
 
 	int notify(const struct sigevent *notification);
@@ -74,6 +100,13 @@ public:
 
 	inline char* getMqName() const { return _name; };
 
+	/** 
+	 * Descriptor of the queue, for select()/poll()/epoll (e.g. by
+	 * CoSchedulerXp). Only on Linux: queues of the Xenomai POSIX skin
+	 * can not be polled, there it throws ENOTSUP.
+	 =================================================*/
+	mqd_t getDescriptor();
+
 private:
 
 	char* _name;               // Name of the message queue
@@ -103,6 +136,8 @@ private:
 	int setAttribute(long flag);
 
 	int getAttribute();
+
+	int pollReceive(char *msg_buf, int buf_size, StopTokenXp& token);
 };
 
 #endif 
\ No newline at end of file
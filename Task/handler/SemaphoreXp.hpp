@@ -0,0 +1,224 @@
+//==============================================================================
+// SemaphoreXp.hpp - Counting semaphore class.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _SEMAPHOREXP_HPP_INCLUDED
+#define _SEMAPHOREXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <semaphore.h>
+#include <limits.h>
+#include <time.h>
+#include <inttypes.h>
+#include "FutexXp.hpp"
+#include "DeadlineXp.hpp"
+#include "znmException.hpp"
+
+//==============================================================================
+// class SemaphoreXp
+//------------------------------------------------------------------------------
+// \brief
+// A counting semaphore with the semantics of sem_t.
+//
+// <ul>
+// <li>wait() and post() do not enter the kernel unless a thread has to
+//     sleep or a sleeping thread has to be woken.
+// <li>post(n) adds n to the count and wakes up to n sleepers with a
+//     single system call, so a pool that frees many resources at once
+//     does not need n calls.
+// <li>Can be placed in shared memory with pshared set to
+//     PTHREAD_PROCESS_SHARED (see ShMemSyncXp::semaphore()).
+// <li>Built on futexes, not on the Xenomai POSIX skin: a thread that
+//     sleeps or wakes others switches to secondary mode.
+// <li>This class will throw an exception of type ZnmException in case of
+//     errors.
+// </ul>
+//==============================================================================
+
+class SemaphoreXp
+{
+ public:
+  inline SemaphoreXp(unsigned int value = 0,
+                     int pshared = PTHREAD_PROCESS_PRIVATE);
+   // Constructs a SemaphoreXp
+   //  value    Initial count, at most SEM_VALUE_MAX.
+   //  pshared  PTHREAD_PROCESS_SHARED if the semaphore lives in
+   //           shared memory and is used by several processes.
+
+  inline void wait();
+   // Decrements the count. If it is zero, blocks until it
+   // is incremented by another thread.
+
+  inline int tryWait();
+   // Returns 0 and decrements the count if it is not zero, else
+   // returns -1.
+
+  inline int timedWait(const struct timespec *to);
+   // Like wait(), but gives up at the absolute time 'to' (CLOCK_REALTIME).
+   //  return  0 if the count was decremented, -1 on timeout.
+
+  inline int timedWait(const DeadlineXp &deadline);
+   // Like timedWait(), with a CLOCK_MONOTONIC deadline or a TimeoutXp.
+
+  inline void post(unsigned int n = 1);
+   // Adds n to the count and wakes up to n waiting threads.
+
+  inline int getValue();
+   // Returns the current count.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  inline bool tryDecrement();
+
+  inline int waitUntil(const struct timespec *to, clockid_t clk_id);
+
+  uint32_t d_value;
+   // Count, futex word
+
+  uint32_t d_waiters;
+   // Threads in the slow path of wait()
+
+  bool d_pshared;
+};
+
+
+//==============================================================================
+// SemaphoreXp::SemaphoreXp()
+//==============================================================================
+SemaphoreXp::SemaphoreXp(unsigned int value /*= 0*/,
+                         int pshared /*= PTHREAD_PROCESS_PRIVATE*/)
+{
+ if(value > SEM_VALUE_MAX)
+  throw(ZnmException("SemaphoreXp", "SemaphoreXp", EINVAL));
+ d_value = value;
+ d_waiters = 0;
+ d_pshared = (pshared == PTHREAD_PROCESS_SHARED);
+}
+
+
+//==============================================================================
+// SemaphoreXp::wait()
+//==============================================================================
+void SemaphoreXp::wait()
+{
+ if(tryDecrement())
+  return;
+ waitUntil(NULL, CLOCK_MONOTONIC);
+}
+
+
+//==============================================================================
+// SemaphoreXp::tryWait()
+//==============================================================================
+int SemaphoreXp::tryWait()
+{
+ return tryDecrement() ? 0 : -1;
+}
+
+
+//==============================================================================
+// SemaphoreXp::timedWait(const struct timespec *to)
+//==============================================================================
+int SemaphoreXp::timedWait(const struct timespec *to)
+{
+ if(tryDecrement())
+  return 0;
+ return waitUntil(to, CLOCK_REALTIME);
+}
+
+
+//==============================================================================
+// SemaphoreXp::timedWait(const DeadlineXp &deadline)
+//==============================================================================
+int SemaphoreXp::timedWait(const DeadlineXp &deadline)
+{
+ struct timespec to;
+
+ if(tryDecrement())
+  return 0;
+ deadline.toTimespec(CLOCK_MONOTONIC, &to);
+ return waitUntil(&to, CLOCK_MONOTONIC);
+}
+
+
+//==============================================================================
+// SemaphoreXp::post(unsigned int n)
+//==============================================================================
+void SemaphoreXp::post(unsigned int n /*= 1*/)
+{
+ uint32_t value = __atomic_load_n(&d_value, __ATOMIC_RELAXED);
+
+ if(n == 0)
+  return;
+
+ do
+ {
+  if(n > SEM_VALUE_MAX - value)
+   throw(ZnmException("SemaphoreXp", "post", EOVERFLOW));
+ } while(!__atomic_compare_exchange_n(&d_value, &value, value + n, false,
+                                      __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+ // Pairs with the increment of d_waiters in waitUntil()
+ if(__atomic_load_n(&d_waiters, __ATOMIC_SEQ_CST) != 0)
+  futexWake(&d_value, (n > INT_MAX) ? INT_MAX : (int)n, d_pshared);
+}
+
+
+//==============================================================================
+// SemaphoreXp::getValue()
+//==============================================================================
+int SemaphoreXp::getValue()
+{
+ return (int)__atomic_load_n(&d_value, __ATOMIC_RELAXED);
+}
+
+
+//==============================================================================
+// SemaphoreXp::tryDecrement()
+//==============================================================================
+bool SemaphoreXp::tryDecrement()
+{
+ uint32_t value = __atomic_load_n(&d_value, __ATOMIC_RELAXED);
+
+ while(value != 0)
+ {
+  if(__atomic_compare_exchange_n(&d_value, &value, value - 1, false,
+                                 __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+   return true;
+ }
+ return false;
+}
+
+
+//==============================================================================
+// SemaphoreXp::waitUntil(const struct timespec *to, clockid_t clk_id)
+//==============================================================================
+int SemaphoreXp::waitUntil(const struct timespec *to, clockid_t clk_id)
+{
+ int errNumber;
+
+ __atomic_add_fetch(&d_waiters, 1, __ATOMIC_SEQ_CST);
+ for(;;)
+ {
+  if(tryDecrement())
+   break;
+
+  errNumber = futexWait(&d_value, 0, to, clk_id, d_pshared);
+  if(errNumber == 0 || errNumber == EAGAIN || errNumber == EINTR)
+   continue;
+
+  __atomic_sub_fetch(&d_waiters, 1, __ATOMIC_RELAXED);
+  if(errNumber == ETIMEDOUT)
+   return -1;
+  throw(ZnmException("SemaphoreXp", "futex_wait", errNumber));
+ }
+ __atomic_sub_fetch(&d_waiters, 1, __ATOMIC_RELAXED);
+ return 0;
+}
+
+#endif // _SEMAPHOREXP_HPP_INCLUDED
@@ -0,0 +1,102 @@
+//==============================================================================
+// ShMemStatsXp.hpp - Per-thread resource usage published in shared memory.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Bounded read() retries
+//==============================================================================
+
+#ifndef _SHMEMSTATS_HPP_INCLUDED
+#define _SHMEMSTATS_HPP_INCLUDED
+
+#include <sys/types.h>
+#include <inttypes.h>
+#include "ShMemCatalogXp.hpp"
+#include "ThreadXp.hpp"
+
+#define STATS_REGION_NAME "thread-stats"  // Catalog region holding the slots
+#define STATS_MAX_SLOTS 64                // Default number of slots
+#define STATS_READ_RETRIES 1000           // Tries of read() on a slot being written
+
+#define STATS_SLOT_FREE 0
+#define STATS_SLOT_USED 1
+
+/**
+ * One published thread. seq is odd while the slot is being written.
+ =================================================*/
+struct ShMemStatsSlot
+{
+	uint32_t state;                   // STATS_SLOT_*
+	uint32_t seq;
+	pid_t pid;
+	pid_t tid;                        // Kernel thread ID, as shown by ps -L
+	char name[THREAD_NAME_LEN];
+	ThreadUsageXp usage;
+};
+
+/**
+ * A table of ThreadUsageXp samples in a region of a ShMemCatalogXp, so
+ * a monitor process can see the CPU time, context switches and page
+ * faults of every publishing thread while they run.
+ *
+ * A thread attach()es once, then publish()es its samples without locks
+ * or system calls. Readers copy a slot with read(), which retries a
+ * bounded number of times while the slot is being written. Slots of
+ * processes that died without detach() are reused by attach().
+ =================================================*/
+class ShMemStatsXp
+{
+	public:
+		/**
+		 * catalog: catalog holding the table, must outlive this object
+		 * maxSlots: used only by the process that creates the region
+		 =================================================*/
+		ShMemStatsXp(ShMemCatalogXp* catalog, int maxSlots = STATS_MAX_SLOTS);
+
+		~ShMemStatsXp();
+
+		/**
+		 * Takes a slot for the calling thread. Returns the slot index,
+		 * or -1 with ENOSPC in getErrnoError() if the table is full.
+		 =================================================*/
+		int attach(const char* name);
+
+		/**
+		 * Releases a slot taken by attach().
+		 =================================================*/
+		void detach(int slot);
+
+		/**
+		 * Stores a sample in a slot taken by attach(). Only the
+		 * attached thread may publish to the slot.
+		 =================================================*/
+		void publish(int slot, const ThreadUsageXp* usage);
+
+		/**
+		 * Copies a consistent snapshot of a slot. Returns false if the
+		 * slot is free, or if it stayed half written for
+		 * STATS_READ_RETRIES tries; getErrnoError() is then ESRCH if
+		 * the publishing process is gone (stale slot, reused by the
+		 * next attach()), else EBUSY.
+		 =================================================*/
+		bool read(int slot, ShMemStatsSlot* out);
+
+		int getSlotCount() const;
+
+		inline int getErrnoError() const { return _errno; };
+
+	private:
+
+		bool claim(int slot, uint32_t expected);
+
+		ShMemStatsSlot* _slots;
+
+		int _numSlots;
+
+		int _errno;
+};
+
+#endif
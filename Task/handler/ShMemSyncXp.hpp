@@ -0,0 +1,142 @@
+//==============================================================================
+// ShMemSyncXp.hpp - Synchronization objects resident in shared memory.
+// Xenomai-version : 2.6.4
+// Compatibility   : XENOMAI, g++
+//
+// Modification History:
+// Date         Version        Modified By			Description
+// 19.10.2026   1.0                                 Initial creation
+// 19.10.2026   1.1                                 Bounded wait for the constructing process
+// 19.10.2026   1.2                                 One construction helper, type tag per slot
+//==============================================================================
+
+#ifndef _SHMEMSYNC_HPP_INCLUDED
+#define _SHMEMSYNC_HPP_INCLUDED
+
+#include <pthread.h>
+#include <time.h>
+#include <inttypes.h>
+#include "ShMemCatalogXp.hpp"
+#include "MutexXp.hpp"
+#include "CondVariableXp.hpp"
+#include "RWLock.hpp"
+#include "PtBarrier.hpp"
+#include "SpinBarrier.hpp"
+#include "SemaphoreXp.hpp"
+#include "znmException.hpp"
+
+#define SYNC_SLOT_HEADER 64          // Object follows the state word on its own cache line
+#define SYNC_INIT_WAIT_MS 1000       // Wait for another constructor before ETIMEDOUT
+
+#define SYNC_STATE_EMPTY 0
+#define SYNC_STATE_INITIALIZING 1
+#define SYNC_STATE_READY 2
+
+#define SYNC_TYPE_MUTEX 1            // Type tag after the state word
+#define SYNC_TYPE_CONDVARIABLE 2
+#define SYNC_TYPE_RWLOCK 3
+#define SYNC_TYPE_BARRIER 4
+#define SYNC_TYPE_SPINBARRIER 5
+#define SYNC_TYPE_SEMAPHORE 6
+
+/**
+ * Constructs MutexXp, CondVariableXp, RWLock, PtBarrier, SpinBarrier and
+ * SemaphoreXp objects in place inside named regions of a ShMemCatalogXp, with
+ * PTHREAD_PROCESS_SHARED set, so threads of different processes can
+ * synchronize on data that lives in the same segment.
+ *
+ * Every object is constructed exactly once: the first caller of a name
+ * constructs it, everyone else (in any process) waits until it is ready
+ * and gets the same object. Calling a getter again with the same name
+ * returns the existing object and ignores the other arguments; a name
+ * already used for another type throws EINVAL. If the
+ * constructing process dies before the object is ready, the getters
+ * throw ETIMEDOUT after SYNC_INIT_WAIT_MS; recreate the segment then.
+ *
+ * Objects are never destroyed, they go away with the segment
+ * (ShMemCatalogXp::unlink()). Do not delete the returned pointers.
+ =================================================*/
+class ShMemSyncXp
+{
+	public:
+		ShMemSyncXp(ShMemCatalogXp* catalog);
+
+		~ShMemSyncXp();
+
+		/**
+		 * Robust by default: a process dying with the mutex held does
+		 * not deadlock its peers (see MutexXp::setRecoveryHook()).
+		 =================================================*/
+		MutexXp* mutex(const char* name,
+						int type = PTHREAD_MUTEX_DEFAULT,
+						int proto = PTHREAD_PRIO_NONE,
+						int robust = PTHREAD_MUTEX_ROBUST);
+
+		CondVariableXp* condVariable(const char* name, clockid_t clk_id = CLOCK_REALTIME);
+
+		RWLock* rwLock(const char* name);
+
+		PtBarrier* barrier(const char* name, int n);
+
+		SpinBarrier* spinBarrier(const char* name, int n, int spinCount = SPIN_BARRIER_SPIN);
+
+		SemaphoreXp* semaphore(const char* name, unsigned int value = 0);
+
+	private:
+
+		template <typename T>
+		class Init;
+
+		/**
+		 * Returns address of the object. If the caller has to construct
+		 * it, *state is set to the slot state to pass to endInit(),
+		 * otherwise *state is NULL and the object is ready. Throws
+		 * EINVAL if the object was constructed with another type.
+		 =================================================*/
+		void* beginInit(const char* name, int size, uint32_t type, uint32_t** state);
+
+		void endInit(uint32_t* state, bool success);
+
+		ShMemCatalogXp* _catalog;
+};
+
+/**
+ * Construction of one object of type T by a getter: the getter calls
+ * done() with the object it constructed in place() if needed() is true.
+ * If the constructor throws, the destructor frees the slot for the next
+ * caller.
+ =================================================*/
+template <typename T>
+class ShMemSyncXp::Init
+{
+	public:
+		Init(ShMemSyncXp* sync, const char* name, uint32_t type) : _sync(sync){
+			_place = _sync->beginInit(name, sizeof(T), type, &_state);
+		}
+
+		~Init(){
+			if(_state != NULL)
+				_sync->endInit(_state, false);
+		}
+
+		bool needed() const { return _state != NULL; }
+
+		void* place() const { return _place; }
+
+		void done(T* object){
+			(void) object;	// Typed only so a getter can not construct another T
+			_sync->endInit(_state, true);
+			_state = NULL;
+		}
+
+		T* object() const { return (T*) _place; }
+
+	private:
+		ShMemSyncXp* _sync;
+
+		void* _place;
+
+		uint32_t* _state;
+};
+
+#endif
@@ -6,8 +6,26 @@
 // Modification History:
 // Date         Version        Modified By			Description
 // 27.10.2015   1.0            Said Nuri UYANIK     Initial creation
+// 19.10.2026   1.1                                 Checkpoint and restore to file
+// 19.10.2026   1.2                                 Checkpoint epoch, fsync, unique tmp file
+// 19.10.2026   1.3                                 open() waits for the creator's ftruncate()
 //==============================================================================
 #include "ShMemXp.hpp"
+#include <sys/stat.h>
+#include <stdio.h>
+#include <sched.h>
+#include <time.h>
+
+static uint64_t checkpointChecksum(const unsigned char *data, uint64_t size){
+	uint64_t hash = 14695981039346656037ULL;
+
+	for(uint64_t i = 0; i < size; i++){
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
 
 ShMemXp::ShMemXp(const char* name, int size){
 	_shmFd = -1;
@@ -118,6 +136,13 @@ void *ShMemXp::open(const char *name, int size){
 		throw ZnmException("Opening failed", "open()", _errno);
 	}
 
+	// Mapping past the end of the object raises SIGBUS on first access
+	if(waitForSize(size) != 0){
+		::close(_shmFd);
+		_shmFd = -1;
+		throw ZnmException("Segment smaller than requested", "open()", _errno);
+	}
+
 	_shmSize = size;
 
 	// Allow shared memory regions to be accessed by the caller 
@@ -142,6 +167,37 @@ void *ShMemXp::open(const char *name, int size){
 	return(_shmMem);
 }
 
+int ShMemXp::waitForSize(int size){
+	struct stat st;
+	struct timespec pause;
+
+	pause.tv_sec = 0;
+	pause.tv_nsec = 100000;
+
+	for(int waits = 0; ; waits++){
+		if(fstat(_shmFd, &st) == -1){
+			_errno = errno;
+			return -1;
+		}
+
+		if(st.st_size >= size)
+			return 0;
+
+		// Size 0 until the creator's ftruncate(), any other size is final
+		if(st.st_size != 0){
+			_errno = EINVAL;
+			return -1;
+		}
+
+		if(waits == SHMEM_OPEN_WAIT_MS * 10){
+			_errno = ETIMEDOUT;
+			return -1;
+		}
+
+		nanosleep(&pause, NULL);
+	}
+}
+
 int ShMemXp::unlink(){
 	if(!_isOwner){
 		_errno = EACCES;
@@ -194,4 +250,183 @@ void* ShMemXp::getShmAddr(){
 
 int ShMemXp::getShmSize(){
 	return _shmSize;
-}
\ No newline at end of file
+}
+
+void ShMemXp::beginUpdate(uint32_t *epoch){
+	// Odd while the update runs, see checkpoint()
+	__atomic_add_fetch(epoch, 1, __ATOMIC_ACQ_REL);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void ShMemXp::endUpdate(uint32_t *epoch){
+	__atomic_add_fetch(epoch, 1, __ATOMIC_RELEASE);
+}
+
+int ShMemXp::checkpoint(const char *path, const uint32_t *epoch){
+	ShMemCheckpointHeader *header;
+	unsigned char *file;
+	std::string tmpPath;
+	std::string dirPath;
+	size_t fileSize;
+	uint32_t before;
+	int copied;
+	int fd;
+
+	// Unique name, concurrent checkpointers must not share the file
+	tmpPath = std::string(path) + ".XXXXXX";
+	fileSize = CHECKPOINT_DATA_OFFSET + _shmSize;
+
+	fd = mkstemp(&tmpPath[0]);
+
+	if(fd == -1){
+		_errno = errno;
+		throw ZnmException("Creating checkpoint file failed", "checkpoint()", _errno);
+	}
+
+	if(ftruncate(fd, fileSize) == -1){
+		_errno = errno;
+		::close(fd);
+		::unlink(tmpPath.c_str());
+		throw ZnmException("Setting size of checkpoint file failed", "checkpoint()", _errno);
+	}
+
+	file = (unsigned char*) mmap(NULL, fileSize, PROTECTION, MAP_SHARED, fd, 0);
+
+	if(file == MAP_FAILED){
+		_errno = errno;
+		::close(fd);
+		::unlink(tmpPath.c_str());
+		throw ZnmException("Mapping checkpoint file failed", "checkpoint()", _errno);
+	}
+
+	// Without an epoch the caller has quiesced the writers. With one,
+	// copy until no update was running or started during the copy.
+	copied = 0;
+
+	for(int i = 0; i < CHECKPOINT_RETRIES && !copied; i++){
+		before = epoch ? __atomic_load_n(epoch, __ATOMIC_ACQUIRE) : 0;
+
+		if(before & 1){
+			sched_yield();
+			continue;
+		}
+
+		memcpy(file + CHECKPOINT_DATA_OFFSET, _shmMem, _shmSize);
+
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		copied = epoch == NULL || __atomic_load_n(epoch, __ATOMIC_RELAXED) == before;
+	}
+
+	if(!copied){
+		munmap(file, fileSize);
+		::close(fd);
+		::unlink(tmpPath.c_str());
+		_errno = EBUSY;
+		return -1;
+	}
+
+	// Data first, header marker is written last
+	header = (ShMemCheckpointHeader*) file;
+	header->magic = CHECKPOINT_MAGIC;
+	header->committed = 0;
+	header->size = _shmSize;
+	header->checksum = checkpointChecksum(file + CHECKPOINT_DATA_OFFSET, _shmSize);
+
+	if(msync(file, fileSize, MS_SYNC) == -1){
+		_errno = errno;
+		munmap(file, fileSize);
+		::close(fd);
+		::unlink(tmpPath.c_str());
+		throw ZnmException("Syncing checkpoint data failed", "checkpoint()", _errno);
+	}
+
+	header->committed = CHECKPOINT_COMMITTED;
+	munmap(file, fileSize);
+
+	// msync() does not make the file size and inode durable, fsync() does
+	if(fsync(fd) == -1){
+		_errno = errno;
+		::close(fd);
+		::unlink(tmpPath.c_str());
+		throw ZnmException("Syncing checkpoint file failed", "checkpoint()", _errno);
+	}
+
+	::close(fd);
+
+	// Replace previous checkpoint atomically
+	if(rename(tmpPath.c_str(), path) == -1){
+		_errno = errno;
+		::unlink(tmpPath.c_str());
+		throw ZnmException("Replacing checkpoint file failed", "checkpoint()", _errno);
+	}
+
+	// Make the rename itself durable
+	dirPath = path;
+	dirPath = (dirPath.rfind('/') == std::string::npos) ? std::string(".") :
+				dirPath.substr(0, dirPath.rfind('/') + 1);
+
+	fd = ::open(dirPath.c_str(), O_RDONLY);
+	if(fd != -1){
+		fsync(fd);
+		::close(fd);
+	}
+
+	_errno = 0;
+	return 0;
+}
+
+int ShMemXp::restore(const char *path){
+	const ShMemCheckpointHeader *header;
+	unsigned char *file;
+	struct stat st;
+	int valid;
+	int fd;
+
+	fd = ::open(path, O_RDONLY);
+
+	if(fd == -1){
+		// No checkpoint, cold start
+		_errno = errno;
+		return -1;
+	}
+
+	if(fstat(fd, &st) == -1){
+		_errno = errno;
+		::close(fd);
+		throw ZnmException("Reading checkpoint file failed", "restore()", _errno);
+	}
+
+	if(st.st_size != CHECKPOINT_DATA_OFFSET + _shmSize){
+		::close(fd);
+		_errno = EINVAL;
+		return -1;
+	}
+
+	file = (unsigned char*) mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if(file == MAP_FAILED){
+		_errno = errno;
+		throw ZnmException("Mapping checkpoint file failed", "restore()", _errno);
+	}
+
+	header = (const ShMemCheckpointHeader*) file;
+
+	valid = header->magic == CHECKPOINT_MAGIC &&
+			header->committed == CHECKPOINT_COMMITTED &&
+			header->size == (uint64_t)_shmSize &&
+			header->checksum == checkpointChecksum(file + CHECKPOINT_DATA_OFFSET, _shmSize);
+
+	if(valid)
+		memcpy(_shmMem, file + CHECKPOINT_DATA_OFFSET, _shmSize);
+
+	munmap(file, st.st_size);
+
+	if(!valid){
+		_errno = EINVAL;
+		return -1;
+	}
+
+	_errno = 0;
+	return 0;
+}
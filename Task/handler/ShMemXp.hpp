@@ -6,6 +6,9 @@
 // Modification History:
 // Date         Version        Modified By			Description
 // 27.10.2015   1.0            Said Nuri UYANIK     Initial creation
+// 19.10.2026   1.1                                 Checkpoint and restore to file
+// 19.10.2026   1.2                                 Checkpoint epoch, fsync, unique tmp file
+// 19.10.2026   1.3                                 open() waits for the creator's ftruncate()
 
 #ifndef _SHMEM_HPP_INCLUDED
 #define _SHMEM_HPP_INCLUDED
@@ -26,6 +29,25 @@
 #define DIRECT_MEMORY_ACCESS O_DIRECT
 #define PROTECTION PROT_READ | PROT_WRITE
 
+#define CHECKPOINT_MAGIC 0x5A4E4D53    // "ZNMS", checkpoint file signature
+#define CHECKPOINT_COMMITTED 0x434F4D54 // "COMT", written after data is synced
+#define CHECKPOINT_DATA_OFFSET 4096    // Data starts on a page boundary
+#define CHECKPOINT_RETRIES 1000        // Copies tried while writers keep updating
+#define SHMEM_OPEN_WAIT_MS 1000        // open() waits this long for the creator to set the size
+
+/**
+ * Header at the start of a checkpoint file. The commit marker is written
+ * and synced only after the data, so a file with a valid marker always
+ * holds a complete snapshot.
+ =================================================*/
+struct ShMemCheckpointHeader
+{
+	uint32_t magic;
+	uint32_t committed;
+	uint64_t size;
+	uint64_t checksum;  // FNV-1a over the data
+};
+
 #include <iostream>
 
 using namespace std;
@@ -44,6 +66,38 @@ class ShMemXp
 
 		int unlink();
 
+		/**
+		 * Consistency marker for checkpoint(). epoch is a word in the
+		 * segment (zero at creation); writers bracket every change of
+		 * the checkpointed state with these calls, one writer at a time.
+		 =================================================*/
+		static void beginUpdate(uint32_t *epoch);
+
+		static void endUpdate(uint32_t *epoch);
+
+		/**
+		 * Writes the segment to path. With an epoch, the segment is
+		 * copied again until no update ran during the copy; returns -1
+		 * with EBUSY if that fails CHECKPOINT_RETRIES times. Without
+		 * one, the caller must keep writers out by other means. File is
+		 * written to a unique path.XXXXXX, fsync()ed and renamed, so a
+		 * crash leaves either the previous or the new checkpoint.
+		 *
+		 * Locks are copied as they are and do not work after restore()
+		 * (their owner is gone). Keep MutexXp and other ShMemSyncXp
+		 * objects in a segment that is not checkpointed;
+		 * ShMemCatalogXp::restore() re-initializes the catalog lock.
+		 =================================================*/
+		int checkpoint(const char *path, const uint32_t *epoch = NULL);
+
+		/**
+		 * Copies a committed checkpoint back into the segment. Call at
+		 * startup, before other processes use the segment.
+		 * Returns 0 on success, -1 if path does not hold a valid
+		 * checkpoint of this size (caller should cold start).
+		 =================================================*/
+		int restore(const char *path);
+
 		inline int getErrnoError() const;
 	
 	private:
@@ -52,6 +106,12 @@ class ShMemXp
 
 		void *open(const char *name, int size);
 
+		/**
+		 * Waits up to SHMEM_OPEN_WAIT_MS until the open segment is at
+		 * least size bytes. Returns 0, or -1 with _errno set.
+		 =================================================*/
+		int waitForSize(int size);
+
 		int close();
 
 
@@ -0,0 +1,225 @@
+//==============================================================================
+// StopTokenXp.cpp - Cooperative stop requests for threads.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#include "StopTokenXp.hpp"
+#include "znmException.hpp"
+#include <string.h>
+#include <unistd.h>
+#include <inttypes.h>
+#include <sys/eventfd.h>
+
+#define ERROR_CHECK_RET_STOP(RET, FNAME) ERROR_CHECK_RET(RET, "StopTokenXp", FNAME)
+
+//==============================================================================
+// StopTokenXp::StopTokenXp
+//==============================================================================
+StopTokenXp::StopTokenXp()
+{
+ d_stop = 0;
+ d_eventFd = -1;
+ d_running = -1;
+ memset(d_callbacks, 0, sizeof(d_callbacks));
+ ERROR_CHECK_RET_STOP( pthread_mutex_init(&d_lock, NULL) ,
+  "pthread_mutex_init");
+ ERROR_CHECK_RET_STOP( pthread_cond_init(&d_done, NULL) ,
+  "pthread_cond_init");
+}
+
+
+//==============================================================================
+// StopTokenXp::~StopTokenXp
+//==============================================================================
+StopTokenXp::~StopTokenXp()
+{
+ if(d_eventFd >= 0)
+  close(d_eventFd);
+ pthread_cond_destroy(&d_done);
+ pthread_mutex_destroy(&d_lock);
+}
+
+
+//==============================================================================
+// StopTokenXp::requestStop
+//==============================================================================
+bool StopTokenXp::requestStop()
+{
+ Callback callback;
+ uint64_t one = 1;
+
+ if(__atomic_exchange_n(&d_stop, 1, __ATOMIC_SEQ_CST) != 0)
+  return false;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_eventFd >= 0 && write(d_eventFd, &one, sizeof(one)) < 0)
+ {
+  // The counter is already set
+ }
+
+ // One callback at a time without d_lock: a callback may take locks the
+ // waiter holds while it registers itself. removeCallback() waits for
+ // the one in d_running.
+ for(int i = 0; i < STOP_MAX_CALLBACKS; i++)
+ {
+  if(d_callbacks[i].function == NULL)
+   continue;
+  callback = d_callbacks[i];
+  d_running = i;
+  d_runner = pthread_self();
+  ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+   "pthread_mutex_unlock");
+
+  callback.function(callback.arg, callback.arg2);
+
+  ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+   "pthread_mutex_lock");
+  d_running = -1;
+  pthread_cond_broadcast(&d_done);
+ }
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return true;
+}
+
+
+//==============================================================================
+// StopTokenXp::stopRequested
+//==============================================================================
+bool StopTokenXp::stopRequested() const
+{
+ return __atomic_load_n(&d_stop, __ATOMIC_ACQUIRE) != 0;
+}
+
+
+//==============================================================================
+// StopTokenXp::reset
+//==============================================================================
+void StopTokenXp::reset()
+{
+ uint64_t count;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ __atomic_store_n(&d_stop, 0, __ATOMIC_SEQ_CST);
+ if(d_eventFd >= 0 && read(d_eventFd, &count, sizeof(count)) < 0)
+ {
+  // Was not signalled
+ }
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+}
+
+
+//==============================================================================
+// StopTokenXp::getDescriptor
+//==============================================================================
+int StopTokenXp::getDescriptor()
+{
+ uint64_t one = 1;
+ int fd;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_eventFd < 0)
+ {
+  d_eventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  // A stop requested before the descriptor existed
+  if(d_eventFd >= 0 && stopRequested() && write(d_eventFd, &one, sizeof(one)) < 0)
+  {
+   // The counter is already set
+  }
+ }
+ fd = d_eventFd;
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return fd;
+}
+
+
+//==============================================================================
+// StopTokenXp::addCallback
+//==============================================================================
+int StopTokenXp::addCallback(void (*callback)(void *, void *), void *arg,
+                             void *arg2 /*= NULL*/)
+{
+ int id = -1;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ for(int i = 0; i < STOP_MAX_CALLBACKS; i++)
+ {
+  if(d_callbacks[i].function == NULL)
+  {
+   d_callbacks[i].function = callback;
+   d_callbacks[i].arg = arg;
+   d_callbacks[i].arg2 = arg2;
+   id = i;
+   break;
+  }
+ }
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return id;
+}
+
+
+//==============================================================================
+// StopTokenXp::removeCallback
+//==============================================================================
+void StopTokenXp::removeCallback(int id)
+{
+ if(id < 0 || id >= STOP_MAX_CALLBACKS)
+  return;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ d_callbacks[id].function = NULL;
+ d_callbacks[id].arg = NULL;
+ d_callbacks[id].arg2 = NULL;
+ // A callback removing itself must not wait for itself
+ while(isRunning(id))
+  ERROR_CHECK_RET_STOP( pthread_cond_wait(&d_done, &d_lock) ,
+   "pthread_cond_wait");
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+}
+
+
+//==============================================================================
+// StopTokenXp::tryRemoveCallback
+//==============================================================================
+bool StopTokenXp::tryRemoveCallback(int id)
+{
+ bool removed = true;
+
+ if(id < 0 || id >= STOP_MAX_CALLBACKS)
+  return true;
+
+ ERROR_CHECK_RET_STOP( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(isRunning(id))
+  removed = false;
+ else
+ {
+  d_callbacks[id].function = NULL;
+  d_callbacks[id].arg = NULL;
+  d_callbacks[id].arg2 = NULL;
+ }
+ ERROR_CHECK_RET_STOP( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return removed;
+}
+
+
+//==============================================================================
+// StopTokenXp::isRunning
+//==============================================================================
+bool StopTokenXp::isRunning(int id) const
+{
+ return d_running == id && !pthread_equal(d_runner, pthread_self());
+}
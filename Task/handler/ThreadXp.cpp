@@ -9,9 +9,22 @@
 #include "ThreadXp.hpp"
 #include "znmException.hpp"
 #include <iostream>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <alloca.h>
+#include <malloc.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 #define ERROR_CHECK_RET_THREAD(RET, FNAME) ERROR_CHECK_RET(RET, "ThreadXp", FNAME);
 
+static __thread ThreadXp *t_self = NULL;
+ // ThreadXp object of the calling thread
+
 //==============================================================================
 // ThreadXp::ThreadXp
 //==============================================================================
@@ -19,19 +32,37 @@ ThreadXp::ThreadXp(int detachstate /*= PTHREAD_CREATE_JOINABLE*/,
         size_t stacksize /*= PTHREAD_STACK_MIN*/,
         int inheritsched /*= PTHREAD_EXPLICIT_SCHED*/,
         int policy /*= SCHED_OTHER*/,
-        int sched_priority /*= 0*/,             // NOT SUPPORTED
-        char *name /*= NULL*/,                  // NOT SUPPORTED
-        int floatingPoint /*= 1*/               // NOT SUPPORTED
-        //xnarch_cpumask_t *cpuMask /*= NULL */ // NOT SUPPORTED
+        int sched_priority /*= 0*/,
+        const char *name /*= NULL*/,
+        int floatingPoint /*= 1*/,              // Ignored
+        const cpu_set_t *cpuMask /*= NULL */
 ) 
 {
- struct sched_param_ex schedParam;
+ struct sched_param schedParam;
 
  schedParam.sched_priority = sched_priority;
  d_threadId = 0;
  d_arg = NULL;
  d_threadRunning = false;
+ d_tid = 0;
+ d_startedHook = NULL;
+ d_hookArg = NULL;
+ d_usageSeq = 0;
+ memset(&d_usage, 0, sizeof(d_usage));
+ d_memFlags = 0;
+ d_heapReserve = 0;
+ d_memError = 0;
+ d_minorFaults = 0;
+ d_majorFaults = 0;
+ d_name[0] = '\0';
+ if(name != NULL)
+  strncat(d_name, name, THREAD_NAME_LEN - 1);
  
+ ERROR_CHECK_RET_THREAD( checkPriority(policy, sched_priority) ,
+  "sched_priority");
+ if(cpuMask != NULL && CPU_COUNT(cpuMask) == 0)
+  throw ZnmException("ThreadXp", "cpuMask", EINVAL);
+
  ERROR_CHECK_RET_THREAD( sem_init (&d_sema ,0, 0) , 
   "sem_init");
  ERROR_CHECK_RET_THREAD( pthread_attr_init(&d_attr) ,
@@ -44,11 +75,11 @@ ThreadXp::ThreadXp(int detachstate /*= PTHREAD_CREATE_JOINABLE*/,
   "pthread_attr_setinheritsched");
  ERROR_CHECK_RET_THREAD( pthread_attr_setschedpolicy(&d_attr, policy),
   "pthread_attr_setschedpolicy");
- //pthread_attr_setschedparam_ex (&d_attr, &schedParam);
- //pthread_attr_setname_np(&d_attr, name );
- //pthread_attr_setfp_np(&d_attr, floatingPoint);
- //if(cpuMask != NULL)
- //	pthread_attr_setaffinity_np(&d_attr, *cpuMask);
+ ERROR_CHECK_RET_THREAD( pthread_attr_setschedparam(&d_attr, &schedParam),
+  "pthread_attr_setschedparam");
+ if(cpuMask != NULL)
+  ERROR_CHECK_RET_THREAD( pthread_attr_setaffinity_np(&d_attr, sizeof(cpu_set_t), cpuMask),
+   "pthread_attr_setaffinity_np");
 
  pthread_mutexattr_t mAttr;
  ERROR_CHECK_RET_THREAD( pthread_mutexattr_init(&mAttr) , 
@@ -88,10 +119,18 @@ int ThreadXp::run(void *arg)
   return EPERM;
  }
  d_arg = arg;
- ERROR_CHECK_RET_THREAD( code = pthread_create(&d_threadId, &d_attr, ThreadXp::threadEntry, this), 
-  "pthread_create");
- if(code == 0)
-  d_threadRunning = true;
+ d_startedHook = NULL;
+ d_hookArg = NULL;
+ d_stopToken.reset();
+ // Not inside ERROR_CHECK_RET_THREAD, which evaluates its argument
+ // again to throw and would create a second thread
+ code = pthread_create(&d_threadId, &d_attr, ThreadXp::threadEntry, this);
+ if(code != 0)
+ {
+  pthread_mutex_unlock(&d_lock);
+  throw ZnmException("ThreadXp", "pthread_create", code);
+ }
+ d_threadRunning = true;
  ERROR_CHECK_RET_THREAD( sem_wait (&d_sema) , 
   "sem_wait");
  ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock)  ,
@@ -100,6 +139,34 @@ int ThreadXp::run(void *arg)
 }
 
 
+//==============================================================================
+// ThreadXp::launch
+//==============================================================================
+int ThreadXp::launch(void *arg, void (*startedHook)(void *), void *hookArg)
+{
+ int code;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock)  ,
+  "pthread_mutex_lock");
+ if(d_threadRunning)
+ {
+  ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock)  , 
+    "pthread_mutex_unlock");
+  return EPERM;
+ }
+ d_arg = arg;
+ d_startedHook = startedHook;
+ d_hookArg = hookArg;
+ d_stopToken.reset();
+ code = pthread_create(&d_threadId, &d_attr, ThreadXp::threadEntry, this);
+ if(code == 0)
+  d_threadRunning = true;
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock)  ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
 //==============================================================================
 // ThreadXp::isThreadRunning
 //==============================================================================
@@ -175,6 +242,375 @@ pthread_t ThreadXp::getThreadId()
 }
 
 
+//==============================================================================
+// ThreadXp::setPriority
+//==============================================================================
+int ThreadXp::setPriority(int policy, int sched_priority)
+{
+ struct sched_param schedParam;
+ int code;
+
+ code = checkPriority(policy, sched_priority);
+ if(code != 0)
+  return code;
+ schedParam.sched_priority = sched_priority;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_threadRunning)
+  code = pthread_setschedparam(d_threadId, policy, &schedParam);
+ else
+ {
+  code = pthread_attr_setschedpolicy(&d_attr, policy);
+  if(code == 0)
+   code = pthread_attr_setschedparam(&d_attr, &schedParam);
+ }
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::setAffinity
+//==============================================================================
+int ThreadXp::setAffinity(const cpu_set_t *cpuMask)
+{
+ int code;
+
+ if(cpuMask == NULL || CPU_COUNT(cpuMask) == 0)
+  return EINVAL;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_threadRunning)
+  code = pthread_setaffinity_np(d_threadId, sizeof(cpu_set_t), cpuMask);
+ else
+  code = pthread_attr_setaffinity_np(&d_attr, sizeof(cpu_set_t), cpuMask);
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::setName
+//==============================================================================
+int ThreadXp::setName(const char *name)
+{
+ int code = 0;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ d_name[0] = '\0';
+ if(name != NULL)
+  strncat(d_name, name, THREAD_NAME_LEN - 1);
+ if(d_threadRunning)
+  code = setThreadName(d_threadId, d_name);
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::setMemoryOptions
+//==============================================================================
+int ThreadXp::setMemoryOptions(int flags, size_t heapReserve /*= 0*/)
+{
+ int code = 0;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_threadRunning)
+  code = EBUSY;
+ else
+ {
+  d_memFlags = flags;
+  d_heapReserve = heapReserve;
+ }
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::getMemoryError
+//==============================================================================
+int ThreadXp::getMemoryError()
+{
+ int code;
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ code = d_memError;
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::getPageFaults
+//==============================================================================
+int ThreadXp::getPageFaults(long *minor, long *major)
+{
+ int code = ESRCH;
+
+ ERROR_CHECK_RET_THREAD( pthread_mutex_lock(&d_lock) ,
+  "pthread_mutex_lock");
+ if(d_threadRunning)
+  code = readFaults(d_tid, minor, major);
+ if(code == 0)
+ {
+  *minor -= d_minorFaults;
+  *major -= d_majorFaults;
+ }
+ ERROR_CHECK_RET_THREAD( pthread_mutex_unlock(&d_lock) ,
+  "pthread_mutex_unlock");
+ return code;
+}
+
+
+//==============================================================================
+// ThreadXp::sampleUsage
+//==============================================================================
+int ThreadXp::sampleUsage(ThreadUsageXp *usage /*= NULL*/)
+{
+ struct timespec ts;
+ struct rusage ru;
+ ThreadUsageXp sample;
+
+ if(t_self != this)
+  return EPERM;
+
+ if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+  return errno;
+ sample.cpuTime = (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+ if(getrusage(RUSAGE_THREAD, &ru) != 0)
+  return errno;
+ sample.voluntarySwitches = ru.ru_nvcsw;
+ sample.involuntarySwitches = ru.ru_nivcsw;
+ sample.minorFaults = ru.ru_minflt;
+ sample.majorFaults = ru.ru_majflt;
+ clock_gettime(CLOCK_MONOTONIC, &ts);
+ sample.sampleTime = (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+
+ // Only this thread writes, readers retry while the count is odd
+ __atomic_store_n(&d_usageSeq, d_usageSeq + 1, __ATOMIC_RELAXED);
+ __atomic_thread_fence(__ATOMIC_RELEASE);
+ d_usage = sample;
+ __atomic_store_n(&d_usageSeq, d_usageSeq + 1, __ATOMIC_RELEASE);
+
+ if(usage != NULL)
+  *usage = sample;
+ return 0;
+}
+
+
+//==============================================================================
+// ThreadXp::getUsage
+//==============================================================================
+void ThreadXp::getUsage(ThreadUsageXp *usage)
+{
+ uint32_t seq;
+
+ do
+ {
+  while((seq = __atomic_load_n(&d_usageSeq, __ATOMIC_ACQUIRE)) & 1)
+   sched_yield();
+  memcpy(usage, &d_usage, sizeof(*usage));
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+ } while(__atomic_load_n(&d_usageSeq, __ATOMIC_RELAXED) != seq);
+}
+
+
+//==============================================================================
+// ThreadXp::getName
+//==============================================================================
+const char *ThreadXp::getName() const
+{
+ return d_name;
+}
+
+//==============================================================================
+// ThreadXp::requestStop
+//==============================================================================
+bool ThreadXp::requestStop()
+{
+ return d_stopToken.requestStop();
+}
+
+
+//==============================================================================
+// ThreadXp::stopRequested
+//==============================================================================
+bool ThreadXp::stopRequested() const
+{
+ return d_stopToken.stopRequested();
+}
+
+
+//==============================================================================
+// ThreadXp::getStopToken
+//==============================================================================
+StopTokenXp &ThreadXp::getStopToken()
+{
+ return d_stopToken;
+}
+
+
+//==============================================================================
+// ThreadXp::setupMemory
+//==============================================================================
+void ThreadXp::setupMemory()
+{
+ int code;
+
+ d_memError = 0;
+ if(d_memFlags & THREAD_MEM_LOCK)
+ {
+  if(mlockall(MCL_CURRENT | MCL_FUTURE) == -1)
+   d_memError = errno;
+ }
+ if(d_heapReserve != 0)
+ {
+  code = reserveHeap(d_heapReserve);
+  if(d_memError == 0)
+   d_memError = code;
+ }
+ if(d_memFlags & THREAD_MEM_PREFAULT_STACK)
+ {
+  code = prefaultStack();
+  if(d_memError == 0)
+   d_memError = code;
+ }
+
+ if(readFaults(d_tid, &d_minorFaults, &d_majorFaults) != 0)
+ {
+  d_minorFaults = 0;
+  d_majorFaults = 0;
+ }
+}
+
+
+//==============================================================================
+// ThreadXp::prefaultStack
+//==============================================================================
+int ThreadXp::prefaultStack()
+{
+ pthread_attr_t attr;
+ void *stackAddr;
+ size_t stackSize;
+ size_t pageSize = sysconf(_SC_PAGESIZE);
+ size_t avail;
+ volatile char *p;
+ char here;
+ int code;
+
+ code = pthread_getattr_np(pthread_self(), &attr);
+ if(code != 0)
+  return code;
+ code = pthread_attr_getstack(&attr, &stackAddr, &stackSize);
+ pthread_attr_destroy(&attr);
+ if(code != 0)
+  return code;
+
+ // The stack grows down towards stackAddr
+ avail = &here - (char *)stackAddr;
+ if(avail <= THREAD_STACK_MARGIN)
+  return 0;
+ avail -= THREAD_STACK_MARGIN;
+
+ p = (volatile char *)alloca(avail);
+ for(size_t i = 0; i < avail; i += pageSize)
+  p[avail - 1 - i] = 0;
+ return 0;
+}
+
+
+//==============================================================================
+// ThreadXp::reserveHeap
+//==============================================================================
+int ThreadXp::reserveHeap(size_t size)
+{
+ size_t pageSize = sysconf(_SC_PAGESIZE);
+ volatile char *p;
+
+ // Keep freed memory in the heap and serve large blocks from it too
+ mallopt(M_TRIM_THRESHOLD, -1);
+ mallopt(M_MMAP_MAX, 0);
+
+ p = (volatile char *)malloc(size);
+ if(p == NULL)
+  return ENOMEM;
+ for(size_t i = 0; i < size; i += pageSize)
+  p[i] = 0;
+ free((void *)p);
+ return 0;
+}
+
+
+//==============================================================================
+// ThreadXp::readFaults
+//==============================================================================
+int ThreadXp::readFaults(pid_t tid, long *minor, long *major)
+{
+ char path[64];
+ char buf[512];
+ char *fields;
+ FILE *file;
+ size_t len;
+ long cminor;
+
+ snprintf(path, sizeof(path), "/proc/self/task/%d/stat", (int)tid);
+ file = fopen(path, "r");
+ if(file == NULL)
+  return errno;
+ len = fread(buf, 1, sizeof(buf) - 1, file);
+ fclose(file);
+ buf[len] = '\0';
+
+ // The name in parentheses may contain spaces
+ fields = strrchr(buf, ')');
+ if(fields == NULL)
+  return EIO;
+ if(sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %ld %ld %ld",
+           minor, &cminor, major) != 3)
+  return EIO;
+ return 0;
+}
+
+
+//==============================================================================
+// ThreadXp::checkPriority
+//==============================================================================
+int ThreadXp::checkPriority(int policy, int sched_priority)
+{
+ int minPrio = sched_get_priority_min(policy);
+ int maxPrio = sched_get_priority_max(policy);
+
+ if(minPrio == -1 || maxPrio == -1)
+  return EINVAL;
+ if(sched_priority < minPrio || sched_priority > maxPrio)
+  return EINVAL;
+ return 0;
+}
+
+
+//==============================================================================
+// ThreadXp::setThreadName
+//==============================================================================
+int ThreadXp::setThreadName(pthread_t thread, const char *name)
+{
+#ifdef __XENO__
+ return pthread_set_name_np(thread, name);
+#else
+ return pthread_setname_np(thread, name);
+#endif
+}
+
+
 //==============================================================================
 // ThreadXp::threadEntry
 //==============================================================================
@@ -187,9 +623,18 @@ void *ThreadXp::threadEntry(void *classPtr)
  
  // Run the thread function
  ThreadXp *tPtr = (ThreadXp *)classPtr;
+ tPtr->d_tid = syscall(SYS_gettid);
+ t_self = tPtr;
+ tPtr->setupMemory();
+ if(tPtr->d_name[0] != '\0')
+  setThreadName(pthread_self(), tPtr->d_name);
  pthread_cleanup_push(&(ThreadXp::threadExit), classPtr);
  tPtr->enterThread(tPtr->d_arg);
- sem_post (&(tPtr->d_sema)); 
+ // After launch() nobody waits on the semaphore for the start
+ if(tPtr->d_startedHook != NULL)
+  tPtr->d_startedHook(tPtr->d_hookArg);
+ else
+  sem_post (&(tPtr->d_sema)); 
  code = tPtr->executeInThread(tPtr->d_arg);
  pthread_testcancel();
  pthread_cleanup_pop(1);
@@ -206,5 +651,7 @@ void ThreadXp::threadExit(void *classPtr)
 {
  ThreadXp *tPtr = (ThreadXp *)classPtr;
  tPtr->exitThread(tPtr->d_arg);
+ tPtr->sampleUsage();
+ t_self = NULL;
  sem_post (&(tPtr->d_sema)); 
 }
@@ -0,0 +1,148 @@
+//==============================================================================
+// WatchdogXp.hpp - Detection of stalled tasks by heartbeat deadlines.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _WATCHDOGXP_HPP_INCLUDED
+#define _WATCHDOGXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <sched.h>
+#include <inttypes.h>
+#include "ThreadXp.hpp"
+#include "DeadlineXp.hpp"
+
+#define WATCHDOG_MAX_ENTRIES 64 // Tasks one watchdog can supervise
+
+#define WATCHDOG_REPORT 0x1 // Print the miss on stderr
+#define WATCHDOG_ABORT 0x2  // abort() the process, after the handler
+
+//==============================================================================
+// class WatchdogHandlerXp
+//------------------------------------------------------------------------------
+// \brief
+// Called by WatchdogXp when a task misses its deadline. Runs in the
+// monitor thread, so it should not block.
+//==============================================================================
+
+class WatchdogHandlerXp
+{
+ public:
+  virtual ~WatchdogHandlerXp() {}
+
+  virtual void missed(int id, const char *name, const TimeoutXp &late) = 0;
+   //  id      Value returned by WatchdogXp::add().
+   //  late    Time since the deadline passed.
+};
+
+
+//==============================================================================
+// class WatchdogXp
+//------------------------------------------------------------------------------
+// \brief
+// A monitor thread that checks heartbeats of registered tasks.
+//
+// <ul>
+// <li>A task add()s itself with a timeout and calls kick() at least once
+//     per timeout, typically once per cycle. kick() is one clock read and
+//     one atomic store.
+// <li>The monitor thread wakes every check period (timerfd on
+//     CLOCK_MONOTONIC) and compares the last kick of every task with its
+//     timeout. A miss is detected at most one check period after the
+//     deadline, so the check period should be a fraction of the shortest
+//     timeout.
+// <li>A miss is reported once per deadline: the handler is called and the
+//     actions of the task are done. The next miss is reported when the
+//     task was kicked again and missed again.
+// <li>Run the monitor at a priority above the supervised tasks, or a
+//     task spinning at high priority can hide its own stall.
+// </ul>
+//
+// <b>Example:</b>
+// <pre>
+//  WatchdogXp watchdog(TimeoutXp::milliseconds(10));
+//  watchdog.start(SCHED_FIFO, 90);
+//  int id = watchdog.add("control", TimeoutXp::milliseconds(50));
+//  for(;;) { ...; watchdog.kick(id); }
+// </pre>
+//==============================================================================
+
+class WatchdogXp
+{
+ public:
+  WatchdogXp(const TimeoutXp &checkPeriod, WatchdogHandlerXp *handler = NULL);
+   //  checkPeriod  How often the monitor thread checks, greater than 0.
+   //  handler      Called for every miss, may be NULL.
+
+  ~WatchdogXp();
+   // Stops the monitor thread.
+
+  int start(int policy = SCHED_OTHER, int sched_priority = 0,
+            const cpu_set_t *cpuMask = NULL);
+   // Starts the monitor thread.
+   //  return  0 on success, and errno code on error.
+
+  void stop();
+   // Stops the monitor thread within one check period and joins it.
+
+  int add(const char *name, const TimeoutXp &timeout,
+          int actions = WATCHDOG_REPORT);
+   // Registers a task. Its first deadline is 'timeout' from now.
+   //  actions  WATCHDOG_REPORT and/or WATCHDOG_ABORT, or 0.
+   //  return  id for kick(), or -1 if all WATCHDOG_MAX_ENTRIES are
+   //          used. Throws ZnmException with EINVAL for a bad timeout.
+
+  void remove(int id);
+   // Stops supervising the task. The id carries a generation, so a
+   // kick() or remove() with it after remove() does not touch a task
+   // added later in the same entry.
+
+  void kick(int id);
+   // Heartbeat of the task, moves its deadline to 'timeout' from now.
+
+  uint64_t getMisses(int id);
+   //  return  deadlines the task has missed since add().
+
+  //======== END OF INTERFACE ========
+
+ private:
+  class Monitor;
+
+  struct Entry
+  {
+   uint32_t state;
+    // Generation << 2 | ENTRY_FREE, ENTRY_SETUP or ENTRY_ACTIVE
+   int64_t timeout;
+   int64_t lastKick;
+   int actions;
+   char name[THREAD_NAME_LEN];
+   uint32_t seen;
+    // State the fields below belong to, monitor thread only
+   int64_t reported;
+    // lastKick of the last reported miss, monitor thread only
+   uint64_t misses;
+    // Written by the monitor thread only
+  };
+
+  Entry *find(int id, uint32_t *state);
+   //  return  entry of id and in *state its state while active, or
+   //          NULL for an id add() can not have returned.
+
+  void check();
+
+  void missed(int id, Entry *e, int64_t late);
+   // e is the copy check() took of the entry.
+
+  Entry d_entries[WATCHDOG_MAX_ENTRIES];
+
+  int64_t d_checkPeriod;
+
+  WatchdogHandlerXp *d_handler;
+
+  Monitor *d_monitor;
+};
+
+#endif // _WATCHDOGXP_HPP_INCLUDED
@@ -7,11 +7,16 @@
 // Date         Version        Modified By			Description
 // 22.10.2015   1.0            Said Nuri UYANIK     Initial creation
 // 24.10.2015                                       Thread ile çalışmada sıkıntı var
+// 19.10.2026   1.1                                 DeadlineXp timeouts for send/receive
+// 19.10.2026   1.3                                 receive() with a StopTokenXp
+// 19.10.2026   1.4                                 getDescriptor() throws under Xenomai
+// 19.10.2026   1.5                                 receive() with a StopTokenXp keeps the blocking mode
 //==============================================================================
 
 #include "MessageQueueXp.hpp"
 #include "znmException.hpp"
 #include <iostream>
+#include <poll.h>
 
 using namespace std;
 
@@ -70,6 +75,8 @@ int MessageQueueXp::setAttribute(long flag){
 		_isBlocking = true;
 	else 
 		throw ZnmException("Unsupported flag", "setAttribute", flag);
+
+	return 0;
 }
 
 int MessageQueueXp::getAttribute(){
@@ -118,7 +125,7 @@ int MessageQueueXp::create(const char *name, int maxNumMsgs, int maxMsgSize){
 	
 	if(_desc != (mqd_t)-1){
 		_isOwner = true;
-		std::cout << "owned " << _name << std::endl;
+		//std::cout << "owned " << std::endl;
 	}else{ // Check for error 
 		// if name already exist, unlink and try again
 		if (errno == EEXIST){
@@ -150,7 +157,7 @@ int MessageQueueXp::open(const char *name){
 		throw ZnmException("Opening message queue failed", "open()", _errno);
 	}
 
-	std::cout << "opened " << std::endl;
+	//std::cout << "opened " << std::endl;
 
 	_errno = 0;
 	return 0;
@@ -222,6 +229,13 @@ int MessageQueueXp::send(const char *msg_buf, int msg_size, const struct timespe
 	return 0;
 }
 
+int MessageQueueXp::send(const char *msg_buf, int msg_size, const DeadlineXp& deadline){
+	struct timespec timeout;
+
+	deadline.toTimespec(CLOCK_REALTIME, &timeout);
+	return send(msg_buf, msg_size, &timeout);
+}
+
 int MessageQueueXp::try_send(const char *msg_buf, int msg_size){
 	
 	// If blocking is available, make it non-blocking
@@ -275,6 +289,84 @@ int MessageQueueXp::receive(char *msg_buf, int buf_size, const struct timespec *
 	return ret_val;
 }
 
+int MessageQueueXp::receive(char *msg_buf, int buf_size, const DeadlineXp& deadline){
+	struct timespec timeout;
+
+	deadline.toTimespec(CLOCK_REALTIME, &timeout);
+	return receive(msg_buf, buf_size, &timeout);
+}
+
+mqd_t MessageQueueXp::getDescriptor(){
+#ifdef __XENO__
+	// Not a Linux descriptor, poll() and epoll_ctl() would reject it
+	_errno = ENOTSUP;
+	throw ZnmException("Xenomai queues can not be polled", "getDescriptor()", _errno);
+#else
+	return _desc;
+#endif
+}
+
+int MessageQueueXp::receive(char *msg_buf, int buf_size, StopTokenXp& token){
+	bool wasBlocking = _isBlocking;
+	int ret_val;
+	int err;
+
+	// try_receive() leaves the queue in O_NONBLOCK, restore the mode the
+	// caller had so a later send() or receive() blocks as before
+	try{
+		ret_val = pollReceive(msg_buf, buf_size, token);
+	}catch(...){
+		try{
+			if(wasBlocking && !_isBlocking)
+				setAttribute(0);
+		}catch(...){
+			// Keep the first error
+		}
+		throw;
+	}
+
+	err = _errno;
+	if(wasBlocking && !_isBlocking)
+		setAttribute(0);
+	_errno = err;
+
+	return ret_val;
+}
+
+int MessageQueueXp::pollReceive(char *msg_buf, int buf_size, StopTokenXp& token){
+	struct pollfd fds[2];
+	int ret_val;
+
+	fds[0].fd = getDescriptor();
+	fds[0].events = POLLIN;
+	fds[1].fd = token.getDescriptor();
+	fds[1].events = POLLIN;
+
+	if(fds[1].fd < 0){
+		_errno = errno;
+		throw ZnmException("Stop token descriptor failed", "receive()", _errno);
+	}
+
+	while(!token.stopRequested()){
+		ret_val = try_receive(msg_buf, buf_size);
+
+		if(ret_val >= 0)
+			return ret_val;
+
+		if(_errno != EAGAIN)
+			throw ZnmException("Receiving message failed", "receive()", _errno);
+
+		// Another reader may take the message, so poll and try again
+		if(poll(fds, 2, -1) == -1 && errno != EINTR){
+			_errno = errno;
+			throw ZnmException("Polling message queue failed", "receive()", _errno);
+		}
+	}
+
+	_errno = ECANCELED;
+	return -1;
+}
+
 int MessageQueueXp::try_receive(char *msg_buf, int buf_size){
 	
 	int ret_val;
@@ -168,7 +168,7 @@ void RWLock::unlock()
 void RWLock::errorCheck(int code)
 {
  if(code == 0) return;
- throw(ErrnoException(code), "[RWLock]");
+ throw(ErrnoException(code, "[RWLock]"));
 }
 
 #endif // _RWLOCK_HPP_INCLUDED
@@ -0,0 +1,106 @@
+//==============================================================================
+// StopTokenXp.hpp - Cooperative stop requests for threads.
+//
+// Author        :
+// Version       : 1.0 (2026)
+// Compatibility : Linux, GCC
+//==============================================================================
+
+#ifndef _STOPTOKENXP_HPP_INCLUDED
+#define _STOPTOKENXP_HPP_INCLUDED
+
+#include <pthread.h>
+#include <errno.h>
+
+#define STOP_MAX_CALLBACKS 16 // Blocking calls that can wait on one token at once
+
+//==============================================================================
+// class StopTokenXp
+//------------------------------------------------------------------------------
+// \brief
+// A flag asking a thread to stop, which also wakes the thread when it is
+// blocked.
+//
+// <ul>
+// <li>Loops poll stopRequested(), a plain atomic load, instead of
+//     relying on cancellation points.
+// <li>Blocking calls that take a token return early once a stop is
+//     requested: CondVariableXp::condWait() through a callback that
+//     broadcasts the condition variable, MessageQueueXp::receive()
+//     by polling getDescriptor() next to the queue.
+// <li>getDescriptor() is an eventfd that becomes readable, and stays
+//     readable, when a stop is requested, so a thread can wait for
+//     its own descriptors and the token in one poll().
+// </ul>
+//==============================================================================
+
+class StopTokenXp
+{
+ public:
+  StopTokenXp();
+
+  ~StopTokenXp();
+
+  bool requestStop();
+   // Sets the flag, makes the descriptor readable and runs the
+   // callbacks, in the calling thread.
+   //  return  true for the call that requested the stop.
+
+  bool stopRequested() const;
+
+  void reset();
+   // Clears the request, for a thread that is started again.
+
+  int getDescriptor();
+   // Creates the eventfd on the first call.
+   //  return  descriptor, -1 if it can not be created.
+
+  int addCallback(void (*callback)(void *, void *), void *arg,
+                  void *arg2 = NULL);
+   // Registers callback(arg, arg2), run by requestStop() e.g. to wake a
+   // waiting thread. What the arguments point to must stay valid until
+   // removeCallback() has returned.
+   //  return  id for removeCallback(), -1 if all STOP_MAX_CALLBACKS
+   //          are used.
+
+  void removeCallback(int id);
+   // Unregisters a callback. If requestStop() is running it in another
+   // thread, waits until it has returned, so the caller must not hold
+   // a lock the callback takes (see tryRemoveCallback()).
+
+  bool tryRemoveCallback(int id);
+   // Like removeCallback(), but does not wait.
+   //  return  false, and the callback stays registered, if another
+   //          thread is running it.
+
+  //======== END OF INTERFACE ========
+
+ private:
+  struct Callback
+  {
+   void (*function)(void *, void *);
+   void *arg;
+   void *arg2;
+  };
+
+  int d_stop;
+
+  bool isRunning(int id) const;
+   // Callback id runs in another thread, called with d_lock held
+
+  int d_eventFd;
+
+  pthread_mutex_t d_lock;
+   // Guards d_callbacks, d_running and the creation of d_eventFd
+
+  pthread_cond_t d_done;
+   // Broadcast when a callback has returned
+
+  int d_running;
+   // Callback run by requestStop(), -1 if none
+  pthread_t d_runner;
+
+  Callback d_callbacks[STOP_MAX_CALLBACKS];
+};
+
+#endif // _STOPTOKENXP_HPP_INCLUDED
@@ -10,8 +10,40 @@
 #define _THREADXP_HPP_INCLUDED
 
 #include <pthread.h>
+#include <sched.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <sys/types.h>
+#include <inttypes.h>
+#include "StopTokenXp.hpp"
+
+#define THREAD_NAME_LEN 16 // Longest thread name the kernel keeps, with '\0'
+
+#define THREAD_MEM_LOCK 0x1           // mlockall(MCL_CURRENT | MCL_FUTURE)
+#define THREAD_MEM_PREFAULT_STACK 0x2 // Touch every page of the thread stack
+#define THREAD_STACK_MARGIN (8 * 1024) // Left untouched at the end of the stack
+
+
+//==============================================================================
+// struct ThreadUsageXp
+//------------------------------------------------------------------------------
+// \brief
+// Resource usage of one thread, see ThreadXp::sampleUsage().
+//==============================================================================
+
+struct ThreadUsageXp
+{
+ int64_t cpuTime;
+  // ns of CPU used (CLOCK_THREAD_CPUTIME_ID)
+ long voluntarySwitches;
+  // The thread blocked
+ long involuntarySwitches;
+  // The thread was preempted
+ long minorFaults;
+ long majorFaults;
+ int64_t sampleTime;
+  // CLOCK_MONOTONIC ns of the sample, 0 if never sampled
+};
 
 
 //==============================================================================
@@ -33,17 +65,27 @@
 
 class ThreadXp
 {
+ friend class ThreadGroupXp;
  public:
  
   ThreadXp(int detachstate = PTHREAD_CREATE_JOINABLE, 
         size_t stacksize = PTHREAD_STACK_MIN,
         int inheritsched = PTHREAD_EXPLICIT_SCHED,
         int policy = SCHED_OTHER,
-        int sched_priority = 0,               // NOT SUPPORTED
-        char *name = NULL,                    // NOT SUPPORTED
-        int floatingPoint = 1);               // NOT SUPPORTED
-       // xnarch_cpumask_t *cpuMask = NULL ); // NOT SUPPORTED
+        int sched_priority = 0,
+        const char *name = NULL,
+        int floatingPoint = 1,
+        const cpu_set_t *cpuMask = NULL);
    // The constructor. Does some initializations.
+   //  sched_priority  Priority for 'policy', must be within
+   //                  sched_get_priority_min/max(policy). Used only
+   //                  with PTHREAD_EXPLICIT_SCHED.
+   //  name            Thread name shown by ps and /proc, truncated
+   //                  to THREAD_NAME_LEN - 1 characters.
+   //  floatingPoint   Ignored, every thread may use the FPU.
+   //  cpuMask         CPUs the thread may run on, NULL for all.
+   // Throws ZnmException with EINVAL if the priority is out of range
+   // or the mask is empty.
   	
   virtual ~ThreadXp();
     // This destructor does nothing. NOTE: If the derived 
@@ -86,6 +128,73 @@ class ThreadXp
   pthread_t getThreadId();
    //  return  Thread ID if the thread is already 
    //           running, else 0.
+
+  int setPriority(int policy, int sched_priority);
+   // Changes the scheduling policy and priority of the running
+   // thread, or of the next run() if it is not running.
+   //  return  0 on success, and errno code on error
+   //          (EINVAL if the priority is out of range).
+
+  int setAffinity(const cpu_set_t *cpuMask);
+   // Changes the CPUs the thread may run on, now if it is running,
+   // else from the next run().
+   //  return  0 on success, and errno code on error.
+
+  int setName(const char *name);
+   // Changes the name of the thread, now if it is running, else
+   // from the next run().
+   //  return  0 on success, and errno code on error.
+
+  int setMemoryOptions(int flags, size_t heapReserve = 0);
+   // Memory setup done by the thread before enterThread(), so that it
+   // does not take page faults later. Applies from the next run().
+   //  flags        THREAD_MEM_LOCK and/or THREAD_MEM_PREFAULT_STACK.
+   //  heapReserve  Bytes to malloc(), touch and free() in the thread.
+   //               Heap trimming and mmap() allocations are turned off
+   //               (mallopt(), for the whole process) so the pages stay
+   //               in the heap for later allocations.
+   //  return  0 on success, EBUSY if the thread is running.
+
+  int getMemoryError();
+   //  return  errno code of the memory setup step that failed in the
+   //          last run() (e.g. EPERM from mlockall()), else 0. The
+   //          thread runs anyway.
+
+  int getPageFaults(long *minor, long *major);
+   // Page faults taken by the thread since its memory setup.
+   //  return  0 on success, ESRCH if the thread is not running, and
+   //          errno code on error.
+
+  int sampleUsage(ThreadUsageXp *usage = NULL);
+   // Reads the CPU time, context switches and faults of the calling
+   // thread (two system calls) and stores them for getUsage(). Must be
+   // called by the thread itself; it is also done when the thread exits.
+   // Under Xenomai the calls switch the thread to secondary mode, so
+   // sample outside the time critical part.
+   //  usage   If not NULL, receives the sample.
+   //  return  0 on success, EPERM if called by another thread, and
+   //          errno code on error.
+
+  void getUsage(ThreadUsageXp *usage);
+   // Copies the last sample. Can be called from any thread.
+
+  const char *getName() const;
+   //  return  name of the thread, empty if none.
+
+  bool requestStop();
+   // Asks the thread to stop, instead of cancel(): wakes it from
+   // blocking calls that take getStopToken(). The thread ends by
+   // returning from executeInThread(); join() waits for that. The
+   // request is cleared by the next run().
+   //  return  true for the call that requested the stop.
+
+  bool stopRequested() const;
+   //  return  true once requestStop() was called. Cheap enough for
+   //          every iteration of a loop.
+
+  StopTokenXp &getStopToken();
+   //  return  token to pass to CondVariableXp::condWait() and
+   //          MessageQueueXp::receive().
     
  protected:
   virtual void enterThread(void *arg) = 0;
@@ -118,6 +227,25 @@ class ThreadXp
   static void threadExit(void *classPtr);
    // Calls cleanup routine for the thread.
 
+  static int checkPriority(int policy, int sched_priority);
+   //  return  0 or EINVAL if sched_priority is invalid for policy.
+
+  static int setThreadName(pthread_t thread, const char *name);
+
+  void setupMemory();
+   // Runs in the thread, before enterThread()
+
+  static int prefaultStack();
+
+  static int reserveHeap(size_t size);
+
+  static int readFaults(pid_t tid, long *minor, long *major);
+   // Fault counters of a thread of this process, from /proc
+
+  int launch(void *arg, void (*startedHook)(void *), void *hookArg);
+   // Like run(), but returns without waiting for enterThread().
+   // The thread calls startedHook(hookArg) when enterThread() is done.
+
   pthread_t d_threadId;
    // Thread ID
   
@@ -135,6 +263,29 @@ class ThreadXp
   
   pthread_mutex_t d_lock;
    // lock for exclusive access to functions
+
+  char d_name[THREAD_NAME_LEN];
+   // Thread name, empty if none
+
+  void (*d_startedHook)(void *);
+  void *d_hookArg;
+   // Set by launch(), NULL after run()
+
+  pid_t d_tid;
+   // Kernel thread ID, set by the thread
+
+  int d_memFlags;
+  size_t d_heapReserve;
+  int d_memError;
+  long d_minorFaults;
+  long d_majorFaults;
+   // Fault counters at the end of the memory setup
+
+  StopTokenXp d_stopToken;
+
+  uint32_t d_usageSeq;
+   // Odd while d_usage is being written
+  ThreadUsageXp d_usage;
   
 };
 #endif // _THREADXP_HPP_INCLUDED
\ No newline at end of file